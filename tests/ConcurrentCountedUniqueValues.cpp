@@ -0,0 +1,117 @@
+/**
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+#define BOOST_TEST_MODULE ConcurrentCountedUniqueValues tests
+
+// Internal Includes
+#include <util/ConcurrentCountedUniqueValues.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using namespace boost::unit_test;
+using namespace util;
+using std::string;
+
+BOOST_AUTO_TEST_CASE(DefaultConstruction) {
+	ConcurrentCountedUniqueValues<string> a;
+	BOOST_CHECK_EQUAL(a.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalCounts) {
+	ConcurrentCountedUniqueValues<string> a;
+	BOOST_CHECK_EQUAL(a.store("foo"), 0);
+	BOOST_CHECK_EQUAL(a.size(), 1);
+	BOOST_CHECK_EQUAL(a.store("bar"), 1);
+	BOOST_CHECK_EQUAL(a.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(SimpleRetrieve) {
+	ConcurrentCountedUniqueValues<string> a;
+	std::size_t fooID = a.store("foo");
+	std::size_t barID = a.store("bar");
+	BOOST_CHECK_EQUAL(a.get(fooID), "foo");
+	BOOST_CHECK_EQUAL(a.get(barID), "bar");
+	BOOST_CHECK_EQUAL(a[fooID], "foo");
+	BOOST_CHECK_EQUAL(a[barID], "bar");
+}
+
+BOOST_AUTO_TEST_CASE(ValueIdentity) {
+	ConcurrentCountedUniqueValues<string> a;
+	std::size_t fooID = a.store("foo");
+	std::size_t barID = a.store("bar");
+	BOOST_CHECK_EQUAL(fooID, a.store("foo"));
+	BOOST_CHECK_EQUAL(barID, a.store("bar"));
+
+	// Checking actual store ID after repeated store IDs
+	BOOST_CHECK_EQUAL(a.store("baz"), 2);
+	BOOST_CHECK_EQUAL(a.store("baz"), 2);
+}
+
+BOOST_AUTO_TEST_CASE(BoundsChecking) {
+	ConcurrentCountedUniqueValues<string> a;
+	BOOST_CHECK_THROW(a.get(0), std::out_of_range);
+	a.store("foo");
+	BOOST_CHECK_NO_THROW(a.get(0));
+	BOOST_CHECK_THROW(a.get(1), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(ManyValues) {
+	// Enough to force several table growths and storage segments.
+	static const int n = 10000;
+	ConcurrentCountedUniqueValues<int> a;
+	for (int i = 0; i < n; ++i) {
+		BOOST_REQUIRE_EQUAL(a.store(i * 7), std::size_t(i));
+	}
+	BOOST_CHECK_EQUAL(a.size(), std::size_t(n));
+	for (int i = 0; i < n; ++i) {
+		BOOST_REQUIRE_EQUAL(a[i], i * 7);
+		BOOST_REQUIRE_EQUAL(a.store(i * 7), std::size_t(i));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentStore) {
+	static const int threadCount = 4;
+	static const int n = 20000;
+	ConcurrentCountedUniqueValues<int> a;
+	std::vector<std::vector<std::size_t> > results(threadCount, std::vector<std::size_t>(n));
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t) {
+		threads.push_back(std::thread([&, t] {
+			// Each thread stores the same values, in a different order.
+			for (int i = 0; i < n; ++i) {
+				int v = (t % 2) ? i : n - 1 - i;
+				results[t][v] = a.store(v);
+				if (a[results[t][v]] != v) {
+					results[t][v] = n;
+				}
+			}
+		}));
+	}
+	for (auto & thread : threads) {
+		thread.join();
+	}
+
+	BOOST_CHECK_EQUAL(a.size(), std::size_t(n));
+	std::vector<bool> seen(n, false);
+	for (int v = 0; v < n; ++v) {
+		std::size_t i = results[0][v];
+		BOOST_REQUIRE_LT(i, std::size_t(n));
+		BOOST_REQUIRE(!seen[i]);
+		seen[i] = true;
+		BOOST_REQUIRE_EQUAL(a[i], v);
+		for (int t = 1; t < threadCount; ++t) {
+			BOOST_REQUIRE_EQUAL(results[t][v], i);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/**
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+#define BOOST_TEST_MODULE CountedUniqueStrings tests
+
+// Internal Includes
+#include <util/CountedUniqueStrings.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+using namespace boost::unit_test;
+using namespace util;
+using std::string;
+
+BOOST_AUTO_TEST_CASE(DefaultConstruction) {
+	CountedUniqueStrings a;
+	BOOST_CHECK_EQUAL(a.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalCounts) {
+	CountedUniqueStrings a;
+	BOOST_CHECK_EQUAL(a.store("foo"), 0);
+	BOOST_CHECK_EQUAL(a.size(), 1);
+	BOOST_CHECK_EQUAL(a.store("bar"), 1);
+	BOOST_CHECK_EQUAL(a.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(SimpleRetrieve) {
+	CountedUniqueStrings a;
+	std::size_t fooID = a.store("foo");
+	std::size_t barID = a.store(string("bar"));
+	BOOST_CHECK_EQUAL(a.get(fooID), "foo");
+	BOOST_CHECK_EQUAL(a.get(barID), "bar");
+	BOOST_CHECK_EQUAL(std::strcmp(a.c_str(fooID), "foo"), 0);
+	BOOST_CHECK_EQUAL(std::strcmp(a.c_str(barID), "bar"), 0);
+	BOOST_CHECK_THROW(a.get(2), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(ValueIdentity) {
+	CountedUniqueStrings a;
+	std::size_t fooID = a.store("foo");
+	std::size_t barID = a.store("bar");
+	BOOST_CHECK_EQUAL(fooID, a.store(string("foo")));
+	BOOST_CHECK_EQUAL(barID, a.store("bar"));
+
+	// Checking actual store ID after repeated store IDs
+	BOOST_CHECK_EQUAL(a.store("baz"), 2);
+	BOOST_CHECK_EQUAL(a.store("baz"), 2);
+
+	// Empty strings and embedded nulls are values too.
+	BOOST_CHECK_EQUAL(a.store(""), 3);
+	BOOST_CHECK_EQUAL(a.store(boost::string_ref("foo\0bar", 7)), 4);
+	BOOST_CHECK_EQUAL(a.store(""), 3);
+	BOOST_CHECK_EQUAL(a.get(4).size(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(StableHandles) {
+	// Small blocks so we go through several, plus some oversized strings.
+	CountedUniqueStrings a(32);
+	std::vector<const char *> handles;
+	for (int i = 0; i < 2000; ++i) {
+		std::ostringstream os;
+		os << "string number " << i;
+		if (i % 100 == 0) {
+			os << string(100, 'x');
+		}
+		BOOST_REQUIRE_EQUAL(a.store(os.str()), std::size_t(i));
+		handles.push_back(a.c_str(i));
+	}
+	for (int i = 0; i < 2000; ++i) {
+		BOOST_REQUIRE_EQUAL(handles[i], a.c_str(i));
+		BOOST_REQUIRE_EQUAL(a[i].data(), a.c_str(i));
+		BOOST_REQUIRE_EQUAL(a.store(string(a.c_str(i))), std::size_t(i));
+	}
+}
@@ -14,8 +14,11 @@
 
 // Library/third-party includes
 #include <BoostTestTargetConfig.h>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
 
 // Standard includes
+#include <iterator>
 #include <vector>
 #include <map>
 #include <string>
@@ -57,3 +60,107 @@ BOOST_AUTO_TEST_CASE(ValueIdentity) {
 	BOOST_CHECK_EQUAL(a.store("baz"), 2);
 	BOOST_CHECK_EQUAL(a.store("baz"), 2);
 }
+
+namespace {
+	/// Stores the values one at a time, for comparison with store_range
+	template<typename Container>
+	std::vector<std::size_t> storeSerially(Container & c, std::vector<int> const& values) {
+		std::vector<std::size_t> ret;
+		for (std::size_t i = 0; i < values.size(); ++i) {
+			ret.push_back(c.store(values[i]));
+		}
+		return ret;
+	}
+
+	std::vector<int> makeValues(std::size_t n, int distinct) {
+		std::vector<int> ret;
+		unsigned int state = 12345;
+		for (std::size_t i = 0; i < n; ++i) {
+			state = state * 1103515245u + 12345u;
+			ret.push_back(int((state >> 16) % distinct));
+		}
+		return ret;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(StoreRangeSmall) {
+	CountedUniqueValues<string> a;
+	a.store("bar");
+	std::vector<string> values;
+	values.push_back("foo");
+	values.push_back("bar");
+	values.push_back("foo");
+	values.push_back("baz");
+	std::vector<std::size_t> indices;
+	a.store_range(values.begin(), values.end(), std::back_inserter(indices));
+	BOOST_REQUIRE_EQUAL(indices.size(), 4);
+	BOOST_CHECK_EQUAL(indices[0], 1);
+	BOOST_CHECK_EQUAL(indices[1], 0);
+	BOOST_CHECK_EQUAL(indices[2], 1);
+	BOOST_CHECK_EQUAL(indices[3], 2);
+	BOOST_CHECK_EQUAL(a.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(StoreRangeMatchesSerial) {
+	std::vector<int> existing = makeValues(500, 2000);
+	std::vector<int> batch = makeValues(20000, 5000);
+	BOOST_REQUIRE_GE(batch.size(), std::size_t(CountedUniqueValues<int>::BULK_THRESHOLD));
+
+	CountedUniqueValues<int> serial;
+	storeSerially(serial, existing);
+	std::vector<std::size_t> expected = storeSerially(serial, batch);
+
+	CountedUniqueValues<int> bulk;
+	storeSerially(bulk, existing);
+	std::vector<std::size_t> indices(batch.size());
+	BOOST_CHECK(bulk.store_range(batch.begin(), batch.end(), indices.begin()) == indices.end());
+
+	BOOST_CHECK_EQUAL(bulk.size(), serial.size());
+	BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(), expected.begin(), expected.end());
+	for (std::size_t i = 0; i < serial.size(); ++i) {
+		BOOST_REQUIRE_EQUAL(bulk[i], serial[i]);
+	}
+}
+
+namespace {
+	/// A value with equality and a hash, but no ordering
+	struct Unordered {
+		int v;
+	};
+
+	bool operator==(Unordered const& a, Unordered const& b) {
+		return a.v == b.v;
+	}
+
+	std::size_t hash_value(Unordered const& a) {
+		return boost::hash<int>()(a.v);
+	}
+
+	struct UnorderedMapPolicy {
+		template<typename A, typename B>
+		struct apply {
+			typedef boost::unordered_map<A, B> type;
+		};
+	};
+}
+
+BOOST_AUTO_TEST_CASE(StoreRangeUnordered) {
+	std::vector<int> batch = makeValues(5000, 300);
+	std::vector<Unordered> values(batch.size());
+	for (std::size_t i = 0; i < batch.size(); ++i) {
+		values[i].v = batch[i];
+	}
+
+	CountedUniqueValues<int> serial;
+	std::vector<std::size_t> expected = storeSerially(serial, batch);
+
+	CountedUniqueValues<Unordered, UnorderedMapPolicy> a;
+	std::vector<std::size_t> indices;
+	a.store_range(values.begin(), values.end(), std::back_inserter(indices));
+
+	BOOST_CHECK_EQUAL(a.size(), serial.size());
+	BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(), expected.begin(), expected.end());
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		BOOST_REQUIRE_EQUAL(a[i].v, serial[i]);
+	}
+}
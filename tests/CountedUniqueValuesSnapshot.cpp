@@ -0,0 +1,167 @@
+/**
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+#define BOOST_TEST_MODULE CountedUniqueValuesSnapshot tests
+
+// Internal Includes
+#include <util/CountedUniqueValuesSnapshot.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+using namespace boost::unit_test;
+using namespace util;
+using std::string;
+
+/// Copies serialized bytes into a buffer with the alignment a memory mapping
+/// would have.
+static std::vector<stdint::uint64_t> alignedCopy(std::string const& bytes) {
+	std::vector<stdint::uint64_t> ret((bytes.size() + 7) / 8 + 1);
+	std::memcpy(&(ret[0]), bytes.data(), bytes.size());
+	return ret;
+}
+
+BOOST_AUTO_TEST_CASE(EmptySnapshot) {
+	CountedUniqueValues<int> a;
+	std::ostringstream os;
+	writeSnapshot(os, a);
+	std::vector<stdint::uint64_t> buf = alignedCopy(os.str());
+	CountedUniqueValuesSnapshot<int> snap(&(buf[0]), os.str().size());
+	BOOST_CHECK_EQUAL(snap.size(), 0);
+	CountedUniqueValuesSnapshot<int>::count_type i = 0;
+	BOOST_CHECK(!snap.find(5, i));
+	BOOST_CHECK_THROW(snap.get(0), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(FixedValues) {
+	CountedUniqueValues<int> a;
+	for (int i = 0; i < 100; ++i) {
+		a.store(i * 7 % 31);
+	}
+	std::ostringstream os;
+	writeSnapshot(os, a);
+	std::vector<stdint::uint64_t> buf = alignedCopy(os.str());
+	CountedUniqueValuesSnapshot<int> snap(&(buf[0]), os.str().size());
+	BOOST_REQUIRE_EQUAL(snap.size(), a.size());
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		BOOST_CHECK_EQUAL(snap[i], a[i]);
+		BOOST_CHECK_EQUAL(snap.get(i), a[i]);
+		CountedUniqueValuesSnapshot<int>::count_type found = 0;
+		BOOST_CHECK(snap.find(a[i], found));
+		BOOST_CHECK_EQUAL(found, i);
+	}
+	CountedUniqueValuesSnapshot<int>::count_type found = 0;
+	BOOST_CHECK(!snap.find(100, found));
+	BOOST_CHECK_THROW(snap.get(a.size()), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(StringValues) {
+	CountedUniqueValues<string> a;
+	a.store("hi");
+	a.store("");
+	a.store("hello world");
+	a.store("hi");
+	std::ostringstream os;
+	writeSnapshot(os, a);
+	std::vector<stdint::uint64_t> buf = alignedCopy(os.str());
+	CountedUniqueValuesSnapshot<string> snap(&(buf[0]), os.str().size());
+	BOOST_REQUIRE_EQUAL(snap.size(), 3);
+	BOOST_CHECK_EQUAL(snap[0], "hi");
+	BOOST_CHECK_EQUAL(snap[1], "");
+	BOOST_CHECK_EQUAL(snap.get(2), "hello world");
+	BOOST_CHECK_EQUAL(string(snap.c_str(2)), "hello world");
+	CountedUniqueValuesSnapshot<string>::count_type found = 0;
+	BOOST_CHECK(snap.find("hello world", found));
+	BOOST_CHECK_EQUAL(found, 2);
+	BOOST_CHECK(snap.find("", found));
+	BOOST_CHECK_EQUAL(found, 1);
+	BOOST_CHECK(!snap.find("hello", found));
+}
+
+BOOST_AUTO_TEST_CASE(CountedUniqueStringsValues) {
+	CountedUniqueStrings a;
+	for (int i = 0; i < 50; ++i) {
+		std::ostringstream s;
+		s << "string" << i;
+		a.store(s.str());
+	}
+	std::ostringstream os;
+	writeSnapshot(os, a);
+	std::vector<stdint::uint64_t> buf = alignedCopy(os.str());
+	CountedUniqueValuesSnapshot<string> snap(&(buf[0]), os.str().size());
+	BOOST_REQUIRE_EQUAL(snap.size(), a.size());
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		BOOST_CHECK_EQUAL(snap[i], a[i]);
+		CountedUniqueValuesSnapshot<string>::count_type found = 0;
+		BOOST_CHECK(snap.find(a[i], found));
+		BOOST_CHECK_EQUAL(found, i);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Validation) {
+	CountedUniqueValues<int> a;
+	a.store(1);
+	a.store(2);
+	std::ostringstream os;
+	writeSnapshot(os, a);
+	std::string bytes = os.str();
+	std::vector<stdint::uint64_t> buf = alignedCopy(bytes);
+
+	// Truncated
+	BOOST_CHECK_THROW(CountedUniqueValuesSnapshot<int>(&(buf[0]), bytes.size() - 1), std::runtime_error);
+	BOOST_CHECK_THROW(CountedUniqueValuesSnapshot<int>(&(buf[0]), 10), std::runtime_error);
+	// Wrong value type
+	BOOST_CHECK_THROW(CountedUniqueValuesSnapshot<double>(&(buf[0]), bytes.size()), std::runtime_error);
+	BOOST_CHECK_THROW(CountedUniqueValuesSnapshot<string>(&(buf[0]), bytes.size()), std::runtime_error);
+	// Bad magic
+	reinterpret_cast<char *>(&(buf[0]))[0] = 'X';
+	BOOST_CHECK_THROW(CountedUniqueValuesSnapshot<int>(&(buf[0]), bytes.size()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ValidationTableTooFull) {
+	CountedUniqueValues<int> a;
+	for (int i = 0; i < 9; ++i) {
+		a.store(i);
+	}
+	std::ostringstream os;
+	writeSnapshot(os, a);
+	std::string bytes = os.str();
+	std::vector<stdint::uint64_t> buf = alignedCopy(bytes);
+	BOOST_CHECK_NO_THROW(CountedUniqueValuesSnapshot<int>(&(buf[0]), bytes.size()));
+
+	// Shrink the recorded table size from 32 to 16 slots: it still fits in
+	// the data, but is over half full, so lookups of absent values could
+	// probe forever.
+	BOOST_REQUIRE_EQUAL(buf[4], 32u);
+	buf[4] = 16;
+	BOOST_CHECK_THROW(CountedUniqueValuesSnapshot<int>(&(buf[0]), bytes.size()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ValidationStringOffsets) {
+	CountedUniqueValues<string> a;
+	a.store("");
+	std::ostringstream os;
+	writeSnapshot(os, a);
+	std::string bytes = os.str();
+	std::vector<stdint::uint64_t> buf = alignedCopy(bytes);
+	BOOST_CHECK_NO_THROW(CountedUniqueValuesSnapshot<string>(&(buf[0]), bytes.size()));
+
+	// The values start with count + 1 offsets: 2 offsets and a NUL round up
+	// to 3 words. Claiming 3 strings would put the last of 4 offsets past
+	// the values.
+	BOOST_REQUIRE_EQUAL(buf[6] - buf[5], 24u);
+	buf[3] = 3;
+	BOOST_CHECK_THROW(CountedUniqueValuesSnapshot<string>(&(buf[0]), bytes.size()), std::runtime_error);
+}
@@ -15,7 +15,8 @@
 #include <BoostTestTargetConfig.h>
 
 // Standard includes
-// - none
+#include <cstddef>
+#include <vector>
 
 using namespace boost::unit_test;
 
@@ -106,3 +107,104 @@ BOOST_AUTO_TEST_CASE(FaceVertexIdentity) {
 		}
 	}
 }
+
+#ifdef UTIL_CUBECOMPONENTS_HAVE_CONSTEXPR
+static_assert(util::CubeComponents::detail::Topology::faceVertices[5][3] == 7, "Topology tables should be usable at compile time");
+#endif
+
+BOOST_AUTO_TEST_CASE(VertexNeighbors) {
+	for (unsigned int i = 0; i < CUBE_CORNER_COUNT; ++i) {
+		Cube::Vertex v = Cube::Vertex(Cube::IDType(i));
+		for (unsigned int m = 0; m < 3; ++m) {
+			BOOST_CHECK_EQUAL(int(v.getNeighbor(m).getID()), int(i ^ (1 << m)));
+			BOOST_CHECK_EQUAL(v.getNeighbor(m).getNeighbor(m), v);
+			BOOST_CHECK_EQUAL(int(util::CubeComponents::vertexCoordinate(i, m)), (i >> m) & 1 ? 1 : -1);
+			BOOST_CHECK_EQUAL(v.get()[m], (i >> m) & 1 ? 1 : -1);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(FaceVertexMembership) {
+	for (unsigned int i = 0; i < CUBE_FACE_COUNT; ++i) {
+		Cube::Face face = Cube::Face(Cube::IDType(i));
+		for (unsigned int k = 0; k < 4; ++k) {
+			Cube::Vertex v = face.getCubeVertex(k);
+			BOOST_CHECK_EQUAL(v, face.getFaceVertex(k).getCubeVertex());
+			BOOST_CHECK_EQUAL(v.getBitset()[face.getFixedBitIndex()], face.getFixedBitValue());
+			BOOST_CHECK(util::CubeComponents::vertexFaceMask(v.getID()) & (1 << i));
+			BOOST_CHECK_EQUAL(v.get()[face.getFixedBitIndex()], face.getCenter()[face.getFixedBitIndex()]);
+		}
+	}
+	for (unsigned int i = 0; i < CUBE_CORNER_COUNT; ++i) {
+		unsigned int faces = 0;
+		for (unsigned int j = 0; j < CUBE_FACE_COUNT; ++j) {
+			faces += (util::CubeComponents::vertexFaceMask(i) >> j) & 1;
+		}
+		BOOST_CHECK_EQUAL(faces, 3);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(EdgeTopology) {
+	for (unsigned int e = 0; e < 12; ++e) {
+		unsigned int a = util::CubeComponents::edgeVertex(e, 0);
+		unsigned int b = util::CubeComponents::edgeVertex(e, 1);
+		BOOST_CHECK_EQUAL(a ^ b, 1u << (e / 4));
+		BOOST_CHECK_EQUAL(util::CubeComponents::vertexEdge(a, e / 4), e);
+		BOOST_CHECK_EQUAL(util::CubeComponents::vertexEdge(b, e / 4), e);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(CaseEdgeMask) {
+	for (unsigned int c = 0; c < 256; ++c) {
+		unsigned int expected = 0;
+		for (unsigned int e = 0; e < 12; ++e) {
+			unsigned int a = util::CubeComponents::edgeVertex(e, 0);
+			unsigned int b = util::CubeComponents::edgeVertex(e, 1);
+			if (((c >> a) & 1) != ((c >> b) & 1)) {
+				expected |= 1 << e;
+			}
+		}
+		BOOST_CHECK_EQUAL(util::CubeComponents::caseEdgeMask(c), expected);
+	}
+}
+
+template<typename Scalar>
+static void checkBatchGeometry() {
+	typedef Eigen::Matrix<Scalar, 3, 1> Vec;
+	typedef util::Cube<Vec> ScalarCube;
+	const std::size_t n = 13;
+	std::vector<Scalar> ox(n), oy(n), oz(n), scale(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		ox[i] = Scalar(i);
+		oy[i] = Scalar(2 * i) - 5;
+		oz[i] = Scalar(0.5) * i;
+		scale[i] = Scalar(1) + Scalar(0.25) * i;
+	}
+	std::vector<Scalar> x(8 * n), y(8 * n), z(8 * n);
+	util::CubeComponents::batchVertexPositions(&(ox[0]), &(oy[0]), &(oz[0]), &(scale[0]), n, &(x[0]), &(y[0]), &(z[0]));
+	for (unsigned int v = 0; v < CUBE_CORNER_COUNT; ++v) {
+		for (std::size_t i = 0; i < n; ++i) {
+			Vec expected = Vec(ox[i], oy[i], oz[i]) + scale[i] * typename ScalarCube::Vertex(typename ScalarCube::IDType(v)).get();
+			BOOST_CHECK_EQUAL(x[v * n + i], expected[0]);
+			BOOST_CHECK_EQUAL(y[v * n + i], expected[1]);
+			BOOST_CHECK_EQUAL(z[v * n + i], expected[2]);
+		}
+	}
+	util::CubeComponents::batchFaceCenters(&(ox[0]), &(oy[0]), &(oz[0]), &(scale[0]), n, &(x[0]), &(y[0]), &(z[0]));
+	for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+		for (std::size_t i = 0; i < n; ++i) {
+			Vec expected = Vec(ox[i], oy[i], oz[i]) + scale[i] * typename ScalarCube::Face(typename ScalarCube::IDType(f)).getCenter();
+			BOOST_CHECK_EQUAL(x[f * n + i], expected[0]);
+			BOOST_CHECK_EQUAL(y[f * n + i], expected[1]);
+			BOOST_CHECK_EQUAL(z[f * n + i], expected[2]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(BatchGeometryFloat) {
+	checkBatchGeometry<float>();
+}
+
+BOOST_AUTO_TEST_CASE(BatchGeometryDouble) {
+	checkBatchGeometry<double>();
+}
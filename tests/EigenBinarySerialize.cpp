@@ -0,0 +1,158 @@
+/**
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+#define BOOST_TEST_MODULE EigenBinarySerialize tests
+
+// Internal Includes
+#include <util/EigenBinarySerialize.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+using namespace boost::unit_test;
+using namespace util;
+
+/// Copies serialized bytes into a buffer with the alignment a memory mapping
+/// would have.
+static std::vector<std::uint64_t> alignedCopy(std::string const& bytes) {
+	std::vector<std::uint64_t> ret(bytes.size() / 8 + 1);
+	std::memcpy(&(ret[0]), bytes.data(), bytes.size());
+	return ret;
+}
+
+BOOST_AUTO_TEST_CASE(FixedAndDynamicRoundTrip) {
+	Eigen::Matrix4d m4 = Eigen::Matrix4d::Random();
+	Eigen::MatrixXf mx = Eigen::MatrixXf::Random(3, 7);
+	Eigen::Matrix<double, 2, 3, Eigen::RowMajor> rowMajor;
+	rowMajor << 1, 2, 3, 4, 5, 6;
+	Eigen::ArrayXi ints = Eigen::ArrayXi::LinSpaced(5, 1, 5);
+	Eigen::Quaterniond q(Eigen::AngleAxisd(0.5, Eigen::Vector3d::UnitY()));
+
+	std::ostringstream os;
+	{
+		EigenBinaryWriter writer(os);
+		writer.write(m4);
+		writer.write(mx);
+		writer.write(rowMajor);
+		writer.write(ints);
+		writer.write(q);
+		writer.write(m4.block<2, 2>(1, 1));
+	}
+	std::string bytes = os.str();
+	BOOST_CHECK_EQUAL(bytes.size() % 8, 0);
+	std::vector<std::uint64_t> buf = alignedCopy(bytes);
+
+	EigenBinaryReader reader(&(buf[0]), bytes.size());
+	BOOST_CHECK_EQUAL(reader.readMap<Eigen::Matrix4d>(), m4);
+	Eigen::MatrixXf mxRead;
+	reader.read(mxRead);
+	BOOST_CHECK_EQUAL(mxRead.rows(), 3);
+	BOOST_CHECK_EQUAL(mxRead, mx);
+	Eigen::Map<const Eigen::Matrix<double, 2, 3, Eigen::RowMajor> > rowMajorRead = reader.readMap<Eigen::Matrix<double, 2, 3, Eigen::RowMajor> >();
+	BOOST_CHECK_EQUAL(rowMajorRead, rowMajor);
+	BOOST_CHECK((reader.readMap<Eigen::ArrayXi>() == ints).all());
+	BOOST_CHECK_EQUAL(reader.readMap<Eigen::Quaterniond>().coeffs(), q.coeffs());
+	Eigen::Matrix2d blockRead;
+	reader.read(blockRead);
+	BOOST_CHECK_EQUAL(blockRead, (m4.block<2, 2>(1, 1)));
+	BOOST_CHECK(reader.atEnd());
+}
+
+BOOST_AUTO_TEST_CASE(ZeroCopyMap) {
+	Eigen::Vector3d v(1, 2, 3);
+	std::ostringstream os;
+	EigenBinaryWriter(os).write(v);
+	std::vector<std::uint64_t> buf = alignedCopy(os.str());
+	EigenBinaryReader reader(&(buf[0]), os.str().size());
+	Eigen::Map<const Eigen::Vector3d> mapped = reader.readMap<Eigen::Vector3d>();
+	BOOST_CHECK_EQUAL(static_cast<const void *>(mapped.data()),
+	                  static_cast<const void *>(reinterpret_cast<const char *>(&(buf[0])) + sizeof(EigenBinaryBlockHeader)));
+}
+
+BOOST_AUTO_TEST_CASE(BulkVector) {
+	std::vector<Eigen::Vector3f> points;
+	std::vector<Eigen::Quaternionf, Eigen::aligned_allocator<Eigen::Quaternionf> > rotations;
+	for (int i = 0; i < 101; ++i) {
+		points.push_back(Eigen::Vector3f(i, 2 * i, -i));
+		rotations.push_back(Eigen::Quaternionf(Eigen::AngleAxisf(0.01f * i, Eigen::Vector3f::UnitZ())));
+	}
+	std::ostringstream os;
+	{
+		EigenBinaryWriter writer(os);
+		writer.write(points);
+		writer.write(rotations);
+		writer.write(std::vector<Eigen::Matrix2d>());
+	}
+	std::vector<std::uint64_t> buf = alignedCopy(os.str());
+	EigenBinaryReader reader(&(buf[0]), os.str().size());
+	BOOST_CHECK_EQUAL(reader.peek().count, points.size());
+	EigenBinaryBlock<Eigen::Vector3f> pointBlock = reader.readBlock<Eigen::Vector3f>();
+	BOOST_REQUIRE_EQUAL(pointBlock.size(), points.size());
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		BOOST_CHECK_EQUAL(pointBlock[i], points[i]);
+	}
+	EigenBinaryBlock<Eigen::Quaternionf> rotationBlock = reader.readBlock<Eigen::Quaternionf>();
+	BOOST_REQUIRE_EQUAL(rotationBlock.size(), rotations.size());
+	for (std::size_t i = 0; i < rotations.size(); ++i) {
+		BOOST_CHECK_EQUAL(rotationBlock[i].coeffs(), rotations[i].coeffs());
+	}
+	BOOST_CHECK_EQUAL(reader.readBlock<Eigen::Matrix2d>().size(), 0);
+	BOOST_CHECK(reader.atEnd());
+}
+
+BOOST_AUTO_TEST_CASE(Validation) {
+	Eigen::Matrix3d m = Eigen::Matrix3d::Identity();
+	std::ostringstream os;
+	EigenBinaryWriter(os).write(m);
+	std::string bytes = os.str();
+	std::vector<std::uint64_t> buf = alignedCopy(bytes);
+
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readMap<Eigen::Matrix3f>(), std::runtime_error);
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readMap<Eigen::Matrix4d>(), std::runtime_error);
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readMap<Eigen::Array33d>(), std::runtime_error);
+	BOOST_CHECK_THROW((EigenBinaryReader(&(buf[0]), bytes.size()).readMap<Eigen::Matrix<double, 3, 3, Eigen::RowMajor> >()), std::runtime_error);
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), bytes.size() - 8).readMap<Eigen::Matrix3d>(), std::runtime_error);
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), 16).peek(), std::runtime_error);
+	BOOST_CHECK_NO_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readMap<Eigen::MatrixXd>());
+}
+
+BOOST_AUTO_TEST_CASE(CorruptDimensions) {
+	Eigen::MatrixXd m = Eigen::MatrixXd::Identity(3, 3);
+	std::ostringstream os;
+	EigenBinaryWriter(os).write(m);
+	std::string bytes = os.str();
+	std::vector<std::uint64_t> buf = alignedCopy(bytes);
+	EigenBinaryBlockHeader & header = *reinterpret_cast<EigenBinaryBlockHeader *>(&(buf[0]));
+
+	// rows * cols * sizeof(double) wraps to zero.
+	header.rows = std::uint64_t(1) << 32;
+	header.cols = std::uint64_t(1) << 32;
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readBlock<Eigen::MatrixXd>(), std::runtime_error);
+
+	// One dimension alone larger than the buffer, the other zero.
+	header.rows = std::uint64_t(1) << 40;
+	header.cols = 0;
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readBlock<Eigen::MatrixXd>(), std::runtime_error);
+
+	// Each dimension fits but their product does not.
+	header.rows = 9;
+	header.cols = 9;
+	BOOST_CHECK_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readBlock<Eigen::MatrixXd>(), std::runtime_error);
+
+	header.rows = 3;
+	header.cols = 3;
+	BOOST_CHECK_NO_THROW(EigenBinaryReader(&(buf[0]), bytes.size()).readMap<Eigen::MatrixXd>());
+}
@@ -15,8 +15,10 @@
 #include <BoostTestTargetConfig.h>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <Eigen/Geometry>
 
 // Standard includes
+#include <stdexcept>
 #include <string>
 #include <sstream>
 
@@ -59,3 +61,127 @@ BOOST_AUTO_TEST_CASE(ConstantVecRoundTrip) {
 	}
 	BOOST_CHECK_EQUAL(Eigen::Vector3d::Constant(1), deserialized);
 }
+
+template<typename T, typename U>
+static void roundTrip(T const& in, U & out) {
+	std::stringstream ss;
+	{
+		boost::archive::text_oarchive outArchive(ss);
+		outArchive << in;
+	}
+	{
+		boost::archive::text_iarchive inArchive(ss);
+		inArchive >> out;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(DynamicRoundTrip) {
+	Eigen::MatrixXd m = Eigen::MatrixXd::Random(3, 5);
+	Eigen::MatrixXd deserialized;
+	roundTrip(m, deserialized);
+	BOOST_CHECK_EQUAL(deserialized.rows(), 3);
+	BOOST_CHECK_EQUAL(deserialized.cols(), 5);
+	BOOST_CHECK_EQUAL(m, deserialized);
+
+	// Loading into an already-sized matrix uses its storage.
+	Eigen::MatrixXd preallocated(3, 5);
+	const double * storage = preallocated.data();
+	roundTrip(m, preallocated);
+	BOOST_CHECK_EQUAL(m, preallocated);
+	BOOST_CHECK_EQUAL(storage, preallocated.data());
+
+	Eigen::VectorXf v = Eigen::VectorXf::LinSpaced(7, 0, 1);
+	Eigen::VectorXf vDeserialized;
+	roundTrip(v, vDeserialized);
+	BOOST_CHECK_EQUAL(v, vDeserialized);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidDynamicSize) {
+	// A size that conflicts with a fixed dimension.
+	Eigen::MatrixXd m = Eigen::MatrixXd::Random(3, 2);
+	Eigen::Matrix<double, Eigen::Dynamic, 3> fixedCols;
+	BOOST_CHECK_THROW(roundTrip(m, fixedCols), std::runtime_error);
+
+	// A negative size, patched into the text of a 1x2 matrix.
+	std::ostringstream os;
+	{
+		boost::archive::text_oarchive oa(os);
+		oa << Eigen::MatrixXd::Constant(1, 2, 5.0).eval();
+	}
+	std::string text = os.str();
+	const std::string::size_type pos = text.find(" 1 2 ");
+	BOOST_REQUIRE(pos != std::string::npos);
+	text.replace(pos, 5, " -1 2 ");
+	std::istringstream is(text);
+	boost::archive::text_iarchive ia(is);
+	Eigen::MatrixXd deserialized;
+	BOOST_CHECK_THROW(ia >> deserialized, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(RowMajorAndArrayRoundTrip) {
+	typedef Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> RowMajorMatrix;
+	RowMajorMatrix m = RowMajorMatrix::Random(4, 3);
+	RowMajorMatrix mDeserialized;
+	roundTrip(m, mDeserialized);
+	BOOST_CHECK_EQUAL(m, mDeserialized);
+
+	// Data is stored in the same order whatever the storage order, so it
+	// may be loaded into the other one.
+	Eigen::MatrixXd colMajor;
+	roundTrip(m, colMajor);
+	BOOST_CHECK_EQUAL(m, colMajor);
+	Eigen::Matrix<double, 4, 3> fixedColMajor = m;
+	Eigen::Matrix<double, 4, 3, Eigen::RowMajor> fixedRowMajor;
+	roundTrip(fixedColMajor, fixedRowMajor);
+	BOOST_CHECK_EQUAL(fixedColMajor, fixedRowMajor);
+	Eigen::Matrix<double, 3, 4> transposed = m.transpose();
+	Eigen::Map<RowMajorMatrix> rowMajorMap(transposed.data(), 4, 3);
+	RowMajorMatrix fromMap;
+	roundTrip(rowMajorMap, fromMap);
+	BOOST_CHECK_EQUAL(m, fromMap);
+
+	Eigen::ArrayXXi a = Eigen::ArrayXXi::Constant(2, 3, 4);
+	a(1, 2) = 7;
+	Eigen::ArrayXXi aDeserialized;
+	roundTrip(a, aDeserialized);
+	BOOST_CHECK((a == aDeserialized).all());
+}
+
+BOOST_AUTO_TEST_CASE(MapAndBlockRoundTrip) {
+	double source[6] = {1, 2, 3, 4, 5, 6};
+	double dest[6] = {0};
+	Eigen::Map<Eigen::MatrixXd> sourceMap(source, 2, 3);
+	Eigen::Map<Eigen::MatrixXd> destMap(dest, 2, 3);
+	roundTrip(sourceMap, destMap);
+	BOOST_CHECK_EQUAL(sourceMap, destMap);
+
+	// A map of the wrong size cannot be loaded into.
+	Eigen::Map<Eigen::MatrixXd> wrongSize(dest, 3, 2);
+	BOOST_CHECK_THROW(roundTrip(sourceMap, wrongSize), std::runtime_error);
+
+	Eigen::Matrix4d big = Eigen::Matrix4d::Random();
+	Eigen::Matrix4d other = Eigen::Matrix4d::Zero();
+	Eigen::Block<Eigen::Matrix4d, 2, 3> sourceBlock = big.block<2, 3>(1, 1);
+	Eigen::Block<Eigen::Matrix4d, 2, 3> destBlock = other.block<2, 3>(0, 0);
+	roundTrip(sourceBlock, destBlock);
+	BOOST_CHECK_EQUAL((big.block<2, 3>(1, 1)), (other.block<2, 3>(0, 0)));
+	BOOST_CHECK_EQUAL(other(3, 3), 0);
+}
+
+BOOST_AUTO_TEST_CASE(GeometryRoundTrip) {
+	Eigen::Quaterniond q(Eigen::AngleAxisd(0.25, Eigen::Vector3d::UnitX()));
+	Eigen::Quaterniond qDeserialized;
+	roundTrip(q, qDeserialized);
+	BOOST_CHECK_EQUAL(q.coeffs(), qDeserialized.coeffs());
+
+	Eigen::Isometry3d t = Eigen::Translation3d(1, 2, 3) * q;
+	Eigen::Isometry3d tDeserialized;
+	roundTrip(t, tDeserialized);
+	BOOST_CHECK_EQUAL(t.matrix(), tDeserialized.matrix());
+
+	// No class information or tracking is stored for them.
+	BOOST_CHECK_EQUAL(int(boost::serialization::implementation_level<Eigen::Quaterniond>::value),
+	                  int(boost::serialization::object_serializable));
+	BOOST_CHECK_EQUAL(int(boost::serialization::tracking_level<Eigen::Isometry3d>::value),
+	                  int(boost::serialization::track_never));
+}
@@ -22,7 +22,7 @@
 #include <Eigen/Core>
 
 // Standard includes
-// - none
+#include <vector>
 
 using namespace boost::unit_test;
 namespace {
@@ -65,6 +65,17 @@ namespace {
 		BOOST_CHECK_NE(util::TieVector(x, y, z), orig);
 		BOOST_CHECK_NE(util::TieVector(x)(y)(z), orig);
 	}
+
+	struct Particle {
+		double x, y, z;
+		double mass;
+	};
+
+	struct UnevenParticle {
+		float x;
+		int id;
+		float y, z;
+	};
 }
 
 BOOST_AUTO_TEST_CASE(ThreeZerosAssign) {
@@ -124,3 +135,109 @@ BOOST_AUTO_TEST_CASE(ThrowsThreeNotUnique) {
 	BOOST_CHECK_THROW(util::TieVector(x)(x)(x) = orig, std::logic_error);
 }
 
+
+BOOST_AUTO_TEST_CASE(TieFunction) {
+	double x, y, z;
+	BOOST_REQUIRE_NO_THROW(util::tie(x, y, z) = Eigen::Vector3d(1, 2, 3));
+	BOOST_CHECK_EQUAL(x, 1);
+	BOOST_CHECK_EQUAL(y, 2);
+	BOOST_CHECK_EQUAL(z, 3);
+	BOOST_CHECK(util::tie(x, y, z) == util::TieVector(x, y, z));
+
+	float a = 4, b = 5;
+	Eigen::Vector2f v = util::tie(a, b);
+	BOOST_CHECK_EQUAL(v, Eigen::Vector2f(4, 5));
+}
+
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+BOOST_AUTO_TEST_CASE(LongTie) {
+	double a, b, c, d, e, f;
+	typedef Eigen::Matrix<double, 6, 1> Vector6d;
+	Vector6d orig;
+	orig << 1, 2, 3, 4, 5, 6;
+	BOOST_REQUIRE_NO_THROW(util::tie(a, b, c, d, e, f) = orig);
+	BOOST_CHECK_EQUAL(a, 1);
+	BOOST_CHECK_EQUAL(f, 6);
+	BOOST_CHECK(util::tie(a, b, c, d, e)(f) == orig);
+
+	BOOST_CHECK_THROW(util::tie(a, b, c, d, e, a) = orig, std::logic_error);
+	BOOST_CHECK_THROW(util::tie(a, b, c, d, e)(c) = orig, std::logic_error);
+}
+#endif // UTIL_EIGEN_TIE_VARIADIC
+
+BOOST_AUTO_TEST_CASE(TieExpressionAssign) {
+	double x = 1, y = 2, z = 3;
+	util::tie(x, y, z) = Eigen::Vector3d(x, y, z) * 2 + Eigen::Vector3d::Ones();
+	BOOST_CHECK(util::tie(x, y, z) == Eigen::Vector3d(3, 5, 7));
+
+	// Swapping through a tie must not see partially-written values.
+	util::tie(x, y, z) = util::tie(z, x, y);
+	BOOST_CHECK(util::tie(x, y, z) == Eigen::Vector3d(7, 3, 5));
+}
+
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+BOOST_AUTO_TEST_CASE(FieldTieGatherScatter) {
+	std::vector<Particle> particles(5);
+	Eigen::Matrix3Xd pos(3, 5);
+	for (int i = 0; i < 5; ++i) {
+		particles[i].mass = -1;
+		pos.col(i) = Eigen::Vector3d(i, 10 * i, 100 * i);
+	}
+	auto fields = util::tieFields(particles, &Particle::x, &Particle::y, &Particle::z);
+	BOOST_CHECK(fields.isSingleMap());
+	BOOST_CHECK_EQUAL(fields.cols(), 5);
+
+	fields = pos;
+	for (int i = 0; i < 5; ++i) {
+		BOOST_CHECK_EQUAL(particles[i].x, i);
+		BOOST_CHECK_EQUAL(particles[i].y, 10 * i);
+		BOOST_CHECK_EQUAL(particles[i].z, 100 * i);
+		BOOST_CHECK_EQUAL(particles[i].mass, -1);
+	}
+
+	Eigen::Matrix3Xd gathered = fields;
+	BOOST_CHECK(gathered == pos);
+
+	fields = (fields.convert() * 2).colwise() + Eigen::Vector3d::Ones();
+	BOOST_CHECK(fields.convert() == (pos * 2).colwise() + Eigen::Vector3d::Ones());
+
+	// Single field, and fields in a different order
+	util::tieFields(particles, &Particle::mass) = Eigen::RowVectorXd::LinSpaced(5, 1, 5);
+	BOOST_CHECK_EQUAL(particles[4].mass, 5);
+	Eigen::Matrix2Xd zx = util::tieFields(particles, &Particle::z, &Particle::x);
+	BOOST_CHECK(zx.row(0) == gathered.row(2) * 2 + Eigen::RowVectorXd::Ones(5));
+}
+
+BOOST_AUTO_TEST_CASE(FieldTieUneven) {
+	UnevenParticle particles[4];
+	Eigen::Matrix3Xf pos = Eigen::Matrix3Xf::Random(3, 4);
+	for (int i = 0; i < 4; ++i) {
+		particles[i].id = i;
+	}
+	auto fields = util::tieFields(particles, 4, &UnevenParticle::x, &UnevenParticle::y, &UnevenParticle::z);
+	BOOST_CHECK(!fields.isSingleMap());
+	fields = pos;
+	for (int i = 0; i < 4; ++i) {
+		BOOST_CHECK_EQUAL(particles[i].id, i);
+		BOOST_CHECK_EQUAL(particles[i].y, pos(1, i));
+	}
+	BOOST_CHECK(fields.convert() == pos);
+	BOOST_CHECK(fields.row(2) == pos.row(2));
+}
+
+BOOST_AUTO_TEST_CASE(FieldTieColumns) {
+	std::vector<Particle> particles(3);
+	auto fields = util::tieFields(particles, &Particle::x, &Particle::y, &Particle::z);
+	fields[1] = Eigen::Vector3d(1, 2, 3);
+	BOOST_CHECK_EQUAL(particles[1].y, 2);
+	BOOST_CHECK(fields[1] == Eigen::Vector3d(1, 2, 3));
+	double x, y, z;
+	util::tie(x, y, z) = fields[1];
+	BOOST_CHECK_EQUAL(z, 3);
+
+	std::vector<Particle> none;
+	auto empty = util::tieFields(none, &Particle::x, &Particle::y);
+	BOOST_CHECK_EQUAL(empty.cols(), 0);
+	BOOST_CHECK_EQUAL(empty.convert().size(), 0);
+}
+#endif // UTIL_EIGEN_TIE_VARIADIC
@@ -14,6 +14,7 @@
 
 // Library/third-party includes
 #include <BoostTestTargetConfig.h>
+#include <boost/fusion/include/at_key.hpp>
 #include <boost/mpl/at.hpp>
 
 // Standard includes
@@ -40,6 +41,12 @@ struct SumFunc {
 	}
 };
 
+struct GenericSum {
+	int operator()(MapType const& m) const {
+		return -(boost::fusion::at_key<One>(m) + boost::fusion::at_key<Two>(m) + boost::fusion::at_key<Three>(m));
+	}
+};
+
 template<typename Key>
 struct ValueAt {
 	typedef int result_type;
@@ -75,3 +82,21 @@ BOOST_AUTO_TEST_CASE(KeywiseFunc) {
 	                       make_pair<Three>(3))))
 	                  , 3);
 }
+
+BOOST_AUTO_TEST_CASE(Fallback) {
+	BOOST_CHECK_EQUAL((util::FusionMapToTemplateWithFallback<SumFunc>(MapType(
+	                       make_pair<One>(1),
+	                       make_pair<Two>(2),
+	                       make_pair<Three>(3)), GenericSum()))
+	                  , 6);
+	BOOST_CHECK_EQUAL((util::FusionMapToTemplateWithFallback<SumFunc>(MapType(
+	                       make_pair<One>(1),
+	                       make_pair<Two>(20),
+	                       make_pair<Three>(3)), GenericSum()))
+	                  , -24);
+	BOOST_CHECK_THROW((util::FusionMapToTemplate<SumFunc>(MapType(
+	                       make_pair<One>(1),
+	                       make_pair<Two>(20),
+	                       make_pair<Three>(3))))
+	                  , std::runtime_error);
+}
@@ -18,6 +18,9 @@
 #include <BoostTestTargetConfig.h>
 
 // Standard includes
+#ifdef UTIL_APPLY_AT_VARIADIC
+#include <tuple>
+#endif
 #include <typeinfo>
 
 using namespace boost::unit_test;
@@ -102,3 +105,40 @@ BOOST_AUTO_TEST_CASE(ActualTypes) {
 	}
 }
 
+
+BOOST_AUTO_TEST_CASE(OutOfRange) {
+	typedef boost::mpl::vector<unsigned int, int, char> sequence;
+	typeinfoptr result = NULL;
+	BOOST_CHECK(util::apply_at<sequence>(2, TypeInfoAddressFunctor(result)));
+	BOOST_CHECK_EQUAL(&typeid(char), result);
+	result = NULL;
+	BOOST_CHECK(!util::apply_at<sequence>(3, TypeInfoAddressFunctor(result)));
+	BOOST_CHECK(result == NULL);
+	// Indices that would wrap around in a narrower type are still rejected.
+	BOOST_CHECK(!util::apply_at<sequence>(257, TypeInfoAddressFunctor(result)));
+	BOOST_CHECK(!util::apply_at<sequence>(-255, TypeInfoAddressFunctor(result)));
+	BOOST_CHECK(result == NULL);
+}
+
+#ifdef UTIL_APPLY_AT_VARIADIC
+template<int N>
+struct Tag {};
+
+BOOST_AUTO_TEST_CASE(TypeList) {
+	typedef std::tuple<unsigned int, int, char, double, float> sequence;
+	typeinfoptr result = NULL;
+	BOOST_CHECK(util::apply_at<sequence>(3, TypeInfoAddressFunctor(result)));
+	BOOST_CHECK_EQUAL(&typeid(double), result);
+	BOOST_CHECK(!util::apply_at<sequence>(5, TypeInfoAddressFunctor(result)));
+
+	// Longer than an MPL vector can be by default.
+	typedef std::tuple < Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>, Tag<6>, Tag<7>, Tag<8>, Tag<9>,
+	        Tag<10>, Tag<11>, Tag<12>, Tag<13>, Tag<14>, Tag<15>, Tag<16>, Tag<17>, Tag<18>, Tag<19>,
+	        Tag<20>, Tag<21>, Tag<22>, Tag<23>, Tag<24>, Tag<25>, Tag<26>, Tag<27>, Tag<28>, Tag<29>,
+	        Tag<30>, Tag<31>, Tag<32>, Tag<33>, Tag<34>, Tag<35>, Tag<36>, Tag<37>, Tag<38>, Tag<39> > tags;
+	for (int i = 0; i < 40; ++i) {
+		BOOST_CHECK(util::apply_at<tags>(i, TypeInfoAddressFunctor(result)));
+	}
+	BOOST_CHECK_EQUAL(&typeid(Tag<39>), result);
+}
+#endif // UTIL_APPLY_AT_VARIADIC
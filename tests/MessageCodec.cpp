@@ -0,0 +1,228 @@
+/** @file
+	@brief Test Implementation
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_TEST_MODULE MessageCodec
+
+// Internal Includes
+#include <util/MessageCodec.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+#include <boost/mpl/vector.hpp>
+
+// Standard includes
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+using namespace boost::unit_test;
+
+namespace {
+	struct Ping {};
+
+	struct Pose {
+		float x, y, z;
+		std::uint32_t id;
+	};
+
+	/// Not trivially copyable, so it has its own wire format, and counts
+	/// destructions to check the storage destroys what it constructs.
+	struct Button {
+		Button() : id(0), pressed(false) {}
+		~Button() {
+			++destroyed;
+		}
+		std::uint16_t id;
+		bool pressed;
+		static int destroyed;
+	};
+	int Button::destroyed = 0;
+} // end of anonymous namespace
+
+namespace util {
+	template<>
+	struct MessageWireFormat<Button> {
+		static const std::size_t size = 3;
+		static void write(Button const& msg, unsigned char * out) {
+			out[0] = msg.id & 0xff;
+			out[1] = msg.id >> 8;
+			out[2] = msg.pressed ? 1 : 0;
+		}
+		static void read(unsigned char const* in, Button & msg) {
+			msg.id = std::uint16_t(in[0] | (in[1] << 8));
+			msg.pressed = in[2] != 0;
+		}
+	};
+} // end of namespace util
+
+typedef util::MessageCodec<boost::mpl::vector<Ping, Pose, Button> > Protocol;
+typedef util::ReceiveBuffer<64> Buffer;
+
+namespace {
+	struct Recorder {
+		std::vector<int> * order;
+		Pose * lastPose;
+		Button * lastButton;
+
+		void operator()(Ping const&) {
+			order->push_back(0);
+		}
+		void operator()(Pose const& p) {
+			order->push_back(1);
+			*lastPose = p;
+		}
+		void operator()(Button const& b) {
+			order->push_back(2);
+			lastButton->id = b.id;
+			lastButton->pressed = b.pressed;
+		}
+	};
+} // end of anonymous namespace
+
+BOOST_AUTO_TEST_CASE(Tags) {
+	BOOST_CHECK_EQUAL(int(Protocol::tag_of<Ping>::value), 0);
+	BOOST_CHECK_EQUAL(int(Protocol::tag_of<Pose>::value), 1);
+	BOOST_CHECK_EQUAL(int(Protocol::tag_of<Button>::value), 2);
+	BOOST_CHECK_EQUAL(Protocol::encodedSize<Ping>(), 1 + sizeof(Ping));
+	BOOST_CHECK_EQUAL(Protocol::encodedSize<Button>(), 4);
+	BOOST_CHECK_EQUAL(Protocol::max_encoded_size, 1 + sizeof(Pose));
+
+	std::vector<unsigned char> bytes;
+	Button b;
+	b.id = 0x1234;
+	b.pressed = true;
+	Protocol::encode(b, std::back_inserter(bytes));
+	BOOST_REQUIRE_EQUAL(bytes.size(), 4);
+	BOOST_CHECK_EQUAL(bytes[0], 2);
+	BOOST_CHECK_EQUAL(bytes[1], 0x34);
+	BOOST_CHECK_EQUAL(bytes[2], 0x12);
+	BOOST_CHECK_EQUAL(bytes[3], 1);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip) {
+	std::vector<unsigned char> bytes;
+	Pose p = {1.5f, -2.f, 3.25f, 42};
+	Button b;
+	b.id = 7;
+	b.pressed = true;
+	Protocol::encode(Ping(), std::back_inserter(bytes));
+	Protocol::encode(p, std::back_inserter(bytes));
+	Protocol::encode(b, std::back_inserter(bytes));
+
+	Buffer buf(bytes.begin(), bytes.end());
+	Protocol::storage_type storage;
+	std::vector<int> order;
+	Pose gotPose = {0, 0, 0, 0};
+	Button gotButton;
+	Recorder rec = {&order, &gotPose, &gotButton};
+	BOOST_CHECK_EQUAL(Protocol::dispatch(buf, storage, rec), util::MessageIncomplete);
+	BOOST_CHECK(buf.empty());
+
+	BOOST_REQUIRE_EQUAL(order.size(), 3);
+	BOOST_CHECK_EQUAL(order[0], 0);
+	BOOST_CHECK_EQUAL(order[1], 1);
+	BOOST_CHECK_EQUAL(order[2], 2);
+	BOOST_CHECK_EQUAL(gotPose.x, p.x);
+	BOOST_CHECK_EQUAL(gotPose.z, p.z);
+	BOOST_CHECK_EQUAL(gotPose.id, p.id);
+	BOOST_CHECK_EQUAL(gotButton.id, 7);
+	BOOST_CHECK(gotButton.pressed);
+
+	BOOST_REQUIRE(storage.holds<Button>());
+	BOOST_CHECK(storage.get<Pose>() == nullptr);
+	BOOST_CHECK_EQUAL(storage.get<Button>()->id, 7);
+}
+
+BOOST_AUTO_TEST_CASE(Incomplete) {
+	std::vector<unsigned char> bytes;
+	Pose p = {1, 2, 3, 4};
+	Protocol::encode(p, std::back_inserter(bytes));
+
+	Buffer buf(bytes.begin(), bytes.end() - 1);
+	Protocol::storage_type storage;
+	BOOST_CHECK_EQUAL(Protocol::decode(buf, storage), util::MessageIncomplete);
+	BOOST_CHECK_EQUAL(buf.size(), bytes.size() - 1);
+	BOOST_CHECK(storage.empty());
+
+	buf.push_back(bytes.back());
+	BOOST_CHECK_EQUAL(Protocol::decode(buf, storage), util::MessageDecoded);
+	BOOST_CHECK(buf.empty());
+	BOOST_REQUIRE(storage.holds<Pose>());
+	BOOST_CHECK_EQUAL(storage.get<Pose>()->id, 4);
+
+	Buffer none;
+	BOOST_CHECK_EQUAL(Protocol::decode(none, storage), util::MessageIncomplete);
+}
+
+BOOST_AUTO_TEST_CASE(UnknownTag) {
+	unsigned char bytes[] = {3, 0, 0, 0};
+	Buffer buf(bytes, 4);
+	Protocol::storage_type storage;
+	BOOST_CHECK_EQUAL(Protocol::decode(buf, storage), util::MessageUnknownTag);
+	BOOST_CHECK_EQUAL(buf.size(), 4);
+
+	std::size_t consumed = 99;
+	BOOST_CHECK_EQUAL(Protocol::decode(bytes, 4, storage, consumed), util::MessageUnknownTag);
+	BOOST_CHECK_EQUAL(consumed, 0);
+}
+
+BOOST_AUTO_TEST_CASE(StorageLifetime) {
+	Button::destroyed = 0;
+	{
+		Protocol::storage_type storage;
+		BOOST_CHECK(!storage.visit(Recorder()));
+		storage.emplace<Button>();
+		BOOST_CHECK_EQUAL(storage.index(), 2);
+		storage.emplace<Ping>();
+		BOOST_CHECK_EQUAL(Button::destroyed, 1);
+		storage.emplace<Button>();
+	}
+	BOOST_CHECK_EQUAL(Button::destroyed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(WideTag) {
+	typedef util::MessageCodec<boost::mpl::vector<Ping, Pose>, std::uint16_t> WideProtocol;
+	std::vector<unsigned char> bytes;
+	Pose p = {1, 2, 3, 4};
+	WideProtocol::encode(p, std::back_inserter(bytes));
+	BOOST_REQUIRE_EQUAL(bytes.size(), 2 + sizeof(Pose));
+	BOOST_CHECK_EQUAL(bytes[0], 1);
+	BOOST_CHECK_EQUAL(bytes[1], 0);
+
+	WideProtocol::storage_type storage;
+	std::size_t consumed = 0;
+	BOOST_CHECK_EQUAL(WideProtocol::decode(&bytes[0], bytes.size(), storage, consumed), util::MessageDecoded);
+	BOOST_CHECK_EQUAL(consumed, bytes.size());
+	BOOST_CHECK_EQUAL(storage.get<Pose>()->z, 3);
+}
+
+BOOST_AUTO_TEST_CASE(SixtyFourBitTag) {
+	typedef util::MessageCodec<boost::mpl::vector<Ping, Pose>, std::uint64_t> WideProtocol;
+	std::vector<unsigned char> bytes;
+	Pose p = {1, 2, 3, 4};
+	WideProtocol::encode(p, std::back_inserter(bytes));
+	BOOST_REQUIRE_EQUAL(bytes.size(), 8 + sizeof(Pose));
+	BOOST_CHECK_EQUAL(bytes[0], 1);
+	for (std::size_t i = 1; i < 8; ++i) {
+		BOOST_CHECK_EQUAL(bytes[i], 0);
+	}
+
+	WideProtocol::storage_type storage;
+	std::size_t consumed = 0;
+	BOOST_CHECK_EQUAL(WideProtocol::decode(&bytes[0], bytes.size(), storage, consumed), util::MessageDecoded);
+	BOOST_CHECK_EQUAL(consumed, bytes.size());
+	BOOST_CHECK_EQUAL(storage.get<Pose>()->z, 3);
+}
@@ -15,7 +15,9 @@
 #include <BoostTestTargetConfig.h>
 
 // Standard includes
-// - none
+#include <climits>
+#include <cstddef>
+#include <vector>
 
 using namespace boost::unit_test;
 using namespace util;
@@ -89,4 +91,114 @@ BOOST_AUTO_TEST_CASE(SameRangeCrossChecking) {
 	BOOST_CHECK_THROW(strict = RangedLoose(7), std::out_of_range);
 }
 
+BOOST_AUTO_TEST_CASE(ExtremeBounds) {
+	typedef RangedInt<INT_MIN, -1> Negative;
+	BOOST_CHECK_NO_THROW(Negative(INT_MIN));
+	BOOST_CHECK_NO_THROW(Negative(-1));
+	BOOST_CHECK_THROW(Negative(0), std::out_of_range);
+	BOOST_CHECK_THROW(Negative(INT_MAX), std::out_of_range);
+
+	typedef RangedInt<0, INT_MAX> NonNegative;
+	BOOST_CHECK_NO_THROW(NonNegative(INT_MAX));
+	BOOST_CHECK_THROW(NonNegative(-1), std::out_of_range);
+	BOOST_CHECK_THROW(NonNegative(INT_MIN), std::out_of_range);
+
+	typedef RangedInt<INT_MIN, INT_MAX> Anything;
+	BOOST_CHECK_NO_THROW(Anything(INT_MIN));
+	BOOST_CHECK_NO_THROW(Anything(INT_MAX));
+}
+
+BOOST_AUTO_TEST_CASE(Prevalidated) {
+	typedef RangedInt<1, 5> Ranged;
+	BOOST_CHECK_EQUAL(sizeof(Ranged), sizeof(int));
+	BOOST_CHECK_NO_THROW(Ranged(7, RangePrevalidated()));
+	BOOST_CHECK_EQUAL(Ranged(3, RangePrevalidated()), 3);
+}
+
+BOOST_AUTO_TEST_CASE(FindOutOfRange) {
+	for (int n = 0; n < 70; ++n) {
+		std::vector<int> data(n + 1);
+		for (int i = 0; i < n; ++i) {
+			data[i] = i % 10;
+		}
+		const int * begin = &data[0];
+		const int * end = begin + n;
+		BOOST_CHECK((findOutOfRange<0, 9>(begin, end) == end));
+		for (int bad = 0; bad < n; bad += 7) {
+			std::vector<int> copy(data);
+			copy[bad] = (bad % 2) ? 10 : -1;
+			if (bad + 3 < n) {
+				copy[bad + 3] = 100;
+			}
+			BOOST_CHECK_EQUAL((findOutOfRange<0, 9>(&copy[0], &copy[0] + n) - &copy[0]), bad);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SpanValidation) {
+	std::vector<int> indices(100);
+	for (int i = 0; i < 100; ++i) {
+		indices[i] = i % 8;
+	}
+	typedef RangedIntSpan<0, 7> Span;
+	BOOST_CHECK_NO_THROW(Span(&indices[0], indices.size()));
+	Span span(&indices[0], indices.size());
+	BOOST_CHECK_EQUAL(span.size(), 100u);
+	BOOST_CHECK_EQUAL(span[9], 1);
+	BOOST_CHECK_EQUAL(span.at(15), 7);
+	BOOST_CHECK_THROW(span.at(100), std::out_of_range);
+
+	indices[77] = 8;
+	BOOST_CHECK_THROW(Span(&indices[0], indices.size()), std::out_of_range);
+	indices[77] = -8;
+	BOOST_CHECK_THROW(Span(&indices[0], indices.size()), std::out_of_range);
+	BOOST_CHECK_NO_THROW((RangedIntSpan<0, 7, NeverCheck>(&indices[0], indices.size())));
+}
 
+BOOST_AUTO_TEST_CASE(DynamicRange) {
+	typedef DynamicRangedInt<int> Ranged;
+	BOOST_CHECK_NO_THROW(Ranged(1, 1, 5));
+	BOOST_CHECK_NO_THROW(Ranged(5, 1, 5));
+	BOOST_CHECK_THROW(Ranged(0, 1, 5), std::out_of_range);
+	BOOST_CHECK_THROW(Ranged(6, 1, 5), std::out_of_range);
+	BOOST_CHECK_THROW(Ranged(INT_MIN, 1, 5), std::out_of_range);
+
+	Ranged val(3, 1, 5);
+	BOOST_CHECK_EQUAL(val + 1, 4);
+	BOOST_CHECK_EQUAL(val.minimum(), 1);
+	BOOST_CHECK_EQUAL(val.maximum(), 5);
+	BOOST_CHECK_NO_THROW(val = 5);
+	BOOST_CHECK_THROW(val = 7, std::out_of_range);
+	BOOST_CHECK_NO_THROW(Ranged(7, 1, 5, RangePrevalidated()));
+}
+
+BOOST_AUTO_TEST_CASE(DynamicRangeWideAndUnsigned) {
+	typedef DynamicRangedInt<std::size_t> Index;
+	const std::size_t n = 10;
+	BOOST_CHECK_NO_THROW(Index(0, 0, n - 1));
+	BOOST_CHECK_NO_THROW(Index(9, 0, n - 1));
+	BOOST_CHECK_THROW(Index(10, 0, n - 1), std::out_of_range);
+	BOOST_CHECK_THROW(Index(std::size_t(-1), 0, n - 1), std::out_of_range);
+	BOOST_CHECK_THROW(Index(2, 3, 4), std::out_of_range);
+
+	typedef DynamicRangedInt<long long> Wide;
+	const long long big = 1LL << 40;
+	BOOST_CHECK_NO_THROW(Wide(big, -big, big));
+	BOOST_CHECK_NO_THROW(Wide(-big, -big, big));
+	BOOST_CHECK_THROW(Wide(big + 1, -big, big), std::out_of_range);
+	BOOST_CHECK_THROW(Wide(-big - 1, -big, big), std::out_of_range);
+	BOOST_CHECK_NO_THROW(Wide(LLONG_MIN, LLONG_MIN, LLONG_MAX));
+	BOOST_CHECK_NO_THROW(Wide(LLONG_MAX, LLONG_MIN, LLONG_MAX));
+}
+
+BOOST_AUTO_TEST_CASE(DynamicRangeNotChecked) {
+	typedef DynamicRangedInt<int, NeverCheck> Ranged;
+	BOOST_CHECK_NO_THROW(Ranged(7, 1, 5));
+	Ranged val(3, 1, 5);
+	BOOST_CHECK_NO_THROW(val = 7);
+	BOOST_CHECK_EQUAL(val, 7);
+
+	std::vector<int> data(20, 2);
+	data[13] = 6;
+	BOOST_CHECK_EQUAL((findOutOfRange(&data[0], &data[0] + data.size(), 1, 5) - &data[0]), 13);
+}
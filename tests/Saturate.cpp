@@ -18,7 +18,10 @@
 #include <Eigen/Geometry>
 
 // Standard includes
+#include <float.h>
 #include <math.h>
+#include <limits>
+#include <vector>
 
 
 using namespace boost::unit_test;
@@ -260,3 +263,269 @@ BOOST_AUTO_TEST_CASE(ThreeParam3DSaturateNeg) {
 	BOOST_CHECK(result == true);
 }
 //--------------------------------------------------------------------
+
+//Batch tests----------------------------------------------------------
+template<typename VecType>
+static std::vector<VecType> makeBatchVectors(std::size_t n, typename VecType::Index dim) {
+	std::vector<VecType> vectors;
+	for (std::size_t i = 0; i < n; ++i) {
+		VecType v(dim);
+		for (typename VecType::Index j = 0; j < dim; ++j) {
+			v[j] = typename VecType::Scalar((int((i * 7 + j * 3) % 11) - 5) * int(i % 4));
+		}
+		vectors.push_back(v);
+	}
+	return vectors;
+}
+
+template<typename VecType>
+static void checkBatchSaturate(typename VecType::Index dim) {
+	typedef typename VecType::Scalar Scalar;
+	const std::size_t n = 300;
+	const Scalar mxMagnitude = 4;
+	std::vector<VecType> vectors = makeBatchVectors<VecType>(n, dim);
+	std::vector<VecType> orig = vectors;
+	bool mask[n];
+	std::size_t count = util::saturateArray(&(vectors[0]), n, mxMagnitude, mask);
+
+	std::size_t expectedCount = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		bool expected = orig[i].norm() > mxMagnitude;
+		expectedCount += expected;
+		BOOST_CHECK_EQUAL(mask[i], expected);
+		if (expected) {
+			BOOST_CHECK_CLOSE(vectors[i].norm(), mxMagnitude, 0.001);
+			BOOST_CHECK_CLOSE(vectors[i].dot(orig[i]), vectors[i].norm() * orig[i].norm(), 0.001);
+		} else {
+			BOOST_CHECK_EQUAL(vectors[i], orig[i]);
+		}
+	}
+	BOOST_CHECK_EQUAL(count, expectedCount);
+	BOOST_CHECK(count > 0 && count < n);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateVector3d) {
+	checkBatchSaturate<Eigen::Vector3d>(3);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateVector3f) {
+	checkBatchSaturate<Eigen::Vector3f>(3);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateVector4f) {
+	checkBatchSaturate<Eigen::Vector4f>(4);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateVectorXd) {
+	checkBatchSaturate<Eigen::VectorXd>(5);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateMatchesSingle) {
+	std::vector<Eigen::Vector3d> vectors = makeBatchVectors<Eigen::Vector3d>(200, 3);
+	std::vector<Eigen::Vector3d> single = vectors;
+	util::saturateArray(&(vectors[0]), vectors.size(), 3.0);
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		util::saturate(single[i], 3.0);
+		for (unsigned int j = 0; j < 3; j++) {
+			BOOST_CHECK_CLOSE(vectors[i][j], single[i][j], 0.0001);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateStructureOfArrays) {
+	std::vector<Eigen::Vector3f> vectors = makeBatchVectors<Eigen::Vector3f>(257, 3);
+	std::vector<float> x, y, z;
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		x.push_back(vectors[i][0]);
+		y.push_back(vectors[i][1]);
+		z.push_back(vectors[i][2]);
+	}
+	std::size_t count = util::saturateArray(&(x[0]), &(y[0]), &(z[0]), x.size(), 4.f);
+	std::size_t expected = util::saturateArray(&(vectors[0]), vectors.size(), 4.f);
+	BOOST_CHECK_EQUAL(count, expected);
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		BOOST_CHECK_CLOSE(x[i] + 1.f, vectors[i][0] + 1.f, 0.001);
+		BOOST_CHECK_CLOSE(y[i] + 1.f, vectors[i][1] + 1.f, 0.001);
+		BOOST_CHECK_CLOSE(z[i] + 1.f, vectors[i][2] + 1.f, 0.001);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateZeroMagnitude) {
+	std::vector<Eigen::Vector3d> vectors = makeBatchVectors<Eigen::Vector3d>(20, 3);
+	std::size_t nonzero = 0;
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		nonzero += vectors[i].squaredNorm() > 0;
+	}
+	BOOST_CHECK_EQUAL(util::saturateArray(&(vectors[0]), vectors.size(), 0.0), nonzero);
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		BOOST_CHECK_EQUAL(vectors[i], Eigen::Vector3d::Zero());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateSquaredNormOverflow) {
+	// Squared norms that overflow float must not zero the vectors.
+	std::vector<Eigen::Vector3f> vectors = makeBatchVectors<Eigen::Vector3f>(200, 3);
+	vectors[3] = Eigen::Vector3f(1e20f, 1e20f, 0.f);
+	vectors[150] = Eigen::Vector3f(0.f, 0.f, -3e19f);
+	std::vector<Eigen::Vector3f> single = vectors;
+	std::vector<float> x, y, z;
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		x.push_back(vectors[i][0]);
+		y.push_back(vectors[i][1]);
+		z.push_back(vectors[i][2]);
+	}
+	util::saturateArray(&(vectors[0]), vectors.size(), 4.f);
+	util::saturateArray(&(x[0]), &(y[0]), &(z[0]), x.size(), 4.f);
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		util::saturate(single[i], 4.f);
+		for (unsigned int j = 0; j < 3; j++) {
+			BOOST_CHECK_CLOSE(vectors[i][j] + 1.f, single[i][j] + 1.f, 0.001);
+		}
+		BOOST_CHECK_CLOSE(x[i] + 1.f, single[i][0] + 1.f, 0.001);
+		BOOST_CHECK_CLOSE(y[i] + 1.f, single[i][1] + 1.f, 0.001);
+		BOOST_CHECK_CLOSE(z[i] + 1.f, single[i][2] + 1.f, 0.001);
+	}
+	BOOST_CHECK_CLOSE(vectors[3].norm(), 4.f, 0.001);
+	BOOST_CHECK_CLOSE(vectors[150][2], -4.f, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSaturateInfiniteMagnitude) {
+	// Nothing exceeds an infinite max magnitude, so nothing changes.
+	std::vector<Eigen::Vector3d> vectors = makeBatchVectors<Eigen::Vector3d>(20, 3);
+	std::vector<Eigen::Vector3d> orig = vectors;
+	const double inf = std::numeric_limits<double>::infinity();
+	BOOST_CHECK_EQUAL(util::saturateArray(&(vectors[0]), vectors.size(), inf), 0);
+	for (std::size_t i = 0; i < vectors.size(); ++i) {
+		BOOST_CHECK_EQUAL(vectors[i], orig[i]);
+		Eigen::Vector3d single = orig[i];
+		BOOST_CHECK(!util::saturate(single, inf));
+		BOOST_CHECK_EQUAL(single, orig[i]);
+	}
+}
+//--------------------------------------------------------------------
+
+//Generic and soft saturation tests-------------------------------------
+BOOST_AUTO_TEST_CASE(GenericFixedAndDynamic) {
+	Eigen::Vector2d v2(3.0, 4.0);
+	BOOST_CHECK(util::saturate(v2, 2.5));
+	BOOST_CHECK_CLOSE(v2[0], 1.5, 0.0001);
+	BOOST_CHECK_CLOSE(v2[1], 2.0, 0.0001);
+
+	Eigen::VectorXd vx = Eigen::VectorXd::Constant(4, 2.0);
+	BOOST_CHECK(util::saturate(vx, 2.0));
+	BOOST_CHECK_CLOSE(vx.norm(), 2.0, 0.0001);
+	BOOST_CHECK(!util::saturate(vx, 3.0));
+
+	// Writable expressions, such as blocks, work too.
+	Eigen::Matrix3d m = Eigen::Matrix3d::Constant(4.0);
+	BOOST_CHECK(util::saturate(m.col(1), 1.0));
+	BOOST_CHECK_CLOSE(m.col(1).norm(), 1.0, 0.0001);
+	BOOST_CHECK_EQUAL(m(0, 0), 4.0);
+}
+
+BOOST_AUTO_TEST_CASE(FloatReciprocalSqrt) {
+	for (float x = 0.001f; x < 1.0e6f; x *= 1.7f) {
+		BOOST_CHECK_CLOSE(util::detail::reciprocalSqrt(x), 1.f / std::sqrt(x), 0.0005);
+	}
+	Eigen::Vector3f vec(4.f, 4.f, 4.f);
+	BOOST_CHECK(util::saturate(vec, 3.f));
+	BOOST_CHECK_CLOSE(vec.norm(), 3.f, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(FloatSquaredNormOverflow) {
+	// The squared norm overflows float to infinity, but the norm does not.
+	const Eigen::Vector3f big(1e20f, 1e20f, 0.f);
+	BOOST_CHECK(big.squaredNorm() > FLT_MAX);
+	const Eigen::Vector3f direction = Eigen::Vector3f(1.f, 1.f, 0.f).normalized();
+
+	Eigen::Vector3f hard = big;
+	BOOST_CHECK(util::saturate(hard, 5.f));
+	BOOST_CHECK_CLOSE(hard.norm(), 5.f, 0.001);
+	BOOST_CHECK_CLOSE(hard.dot(direction), 5.f, 0.001);
+
+	Eigen::Vector3f knee = big;
+	BOOST_CHECK(util::saturateUsing<util::CubicKneeSaturation>(knee, 5.f));
+	BOOST_CHECK_CLOSE(knee.norm(), 5.f, 0.001);
+	BOOST_CHECK_CLOSE(knee.dot(direction), 5.f, 0.001);
+
+	Eigen::Vector3f soft(1e20f, 0.f, 0.f);
+	Eigen::Vector3f other(1.f, 1.f, 1.f);
+	BOOST_CHECK(util::saturateUsing<util::TanhSaturation>(soft, 1.f, other));
+	BOOST_CHECK_CLOSE(soft[0], 1.f, 0.001);
+	BOOST_CHECK_EQUAL(soft[1], 0.f);
+	BOOST_CHECK(other.allFinite());
+
+	Eigen::Vector3f unit(1e20f, 0.f, 0.f);
+	BOOST_CHECK(util::saturate(unit, 1.f));
+	BOOST_CHECK_CLOSE(unit[0], 1.f, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(Vector3dMatchesOldFormula) {
+	// Pseudo-random vectors over a range of magnitudes, compared bit for bit
+	// with the original maxMagnitude / vec.norm() scaling.
+	unsigned int state = 12345;
+	for (int i = 0; i < 10000; ++i) {
+		Eigen::Vector3d vec;
+		for (unsigned int j = 0; j < 3; j++) {
+			state = state * 1103515245u + 12345u;
+			vec[j] = (double((state >> 8) & 0xFFFF) - 32768.0) / 1000.0;
+		}
+		const double mxMagnitude = 1.0 + (i % 17);
+		Eigen::Vector3d expected = vec;
+		Eigen::Vector3d other = Eigen::Vector3d::Ones();
+		Eigen::Vector3d expectedOther = other;
+		if (expected.squaredNorm() > mxMagnitude * mxMagnitude) {
+			const double reduction = (mxMagnitude / expected.norm());
+			expected *= reduction;
+			expectedOther *= reduction;
+		}
+		util::saturate(vec, mxMagnitude, other);
+		BOOST_CHECK(vec == expected);
+		BOOST_CHECK(other == expectedOther);
+	}
+}
+
+template<typename Mode>
+static void checkSoftSaturation() {
+	const double mxMagnitude = 2.0;
+	double previous = 0;
+	for (double length = 0.0; length < 20.0; length += 0.01) {
+		Eigen::Vector3d vec(0.0, length, 0.0);
+		Eigen::Vector3d other(1.0, 1.0, 1.0);
+		util::saturateUsing<Mode>(vec, mxMagnitude, other);
+		double magnitude = vec.norm();
+		// Never beyond the max, never growing, monotonic and continuous.
+		BOOST_CHECK(magnitude <= mxMagnitude * (1 + 1e-12));
+		BOOST_CHECK(magnitude <= length + 1e-12);
+		BOOST_CHECK(magnitude >= previous - 1e-12);
+		BOOST_CHECK(magnitude - previous < 0.0101);
+		if (length > 0) {
+			BOOST_CHECK_CLOSE(other[0], magnitude / length, 0.0001);
+		}
+		previous = magnitude;
+	}
+	BOOST_CHECK_CLOSE(previous, mxMagnitude, 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(SoftSaturationTanh) {
+	checkSoftSaturation<util::TanhSaturation>();
+	Eigen::Vector3d zero = Eigen::Vector3d::Zero();
+	BOOST_CHECK(!util::saturateUsing<util::TanhSaturation>(zero, 1.0));
+}
+
+BOOST_AUTO_TEST_CASE(SoftSaturationTanhDenormal) {
+	// The squared norm is a denormal float: tanh(r) / r rounds to 1.
+	Eigen::Vector3f tiny(1e-20f, 0.f, 0.f);
+	BOOST_CHECK(tiny.squaredNorm() > 0 && tiny.squaredNorm() < FLT_MIN);
+	BOOST_CHECK(!util::saturateUsing<util::TanhSaturation>(tiny, 1.0f));
+	BOOST_CHECK_EQUAL(tiny[0], 1e-20f);
+	BOOST_CHECK(util::detail::reciprocalSqrt(tiny.squaredNorm()) > 0);
+}
+
+BOOST_AUTO_TEST_CASE(SoftSaturationCubicKnee) {
+	checkSoftSaturation<util::CubicKneeSaturation>();
+	Eigen::Vector3d vec(0.0, 0.0, 3.0);
+	BOOST_CHECK(util::saturateUsing<util::CubicKneeSaturation>(vec, 2.0));
+	BOOST_CHECK_CLOSE(vec[2], 2.0, 0.0001);
+}
+//--------------------------------------------------------------------
@@ -14,12 +14,18 @@
 
 // Library/third-party includes
 #include <BoostTestTargetConfig.h>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 // Standard includes
 #include <vector>
 #include <map>
 #include <algorithm>
 
+#ifndef BOOST_NO_CXX11_HDR_UNORDERED_SET
+#include <unordered_set>
+#endif
+
 
 using namespace boost::unit_test;
 using namespace util;
@@ -254,6 +260,41 @@ BOOST_AUTO_TEST_CASE(MapUpdate) {
 	BOOST_CHECK(m.find(b)->second == 2);
 }
 
+BOOST_AUTO_TEST_CASE(MutatorAliasing) {
+	Set2<int> a(5, 10);
+	a.set(a.second(), 1);
+	BOOST_CHECK_EQUAL(a.first(), 1);
+	BOOST_CHECK_EQUAL(a.second(), 10);
+	a.set(a.second(), a.first());
+	BOOST_CHECK_EQUAL(a.first(), 1);
+	BOOST_CHECK_EQUAL(a.second(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(Hashing) {
+	BOOST_CHECK_EQUAL(hash_value(Set2<int>(5, 10)), hash_value(Set2<int>(10, 5)));
+	BOOST_CHECK_EQUAL(boost::hash<Set2<int> >()(Set2<int>(5, 10)), hash_value(Set2<int>(5, 10)));
+
+	boost::unordered_set<Set2<int> > s;
+	s.insert(Set2<int>(5, 10));
+	s.insert(Set2<int>(10, 5));
+	s.insert(Set2<int>(20, 30));
+	BOOST_CHECK_EQUAL(s.size(), 2);
+
+	boost::unordered_map<Set2<int>, int> m;
+	m[Set2<int>(5, 10)] = 1;
+	m[Set2<int>(10, 5)] = 3;
+	BOOST_REQUIRE_EQUAL(m.size(), 1);
+	BOOST_CHECK_EQUAL(m.at(Set2<int>(5, 10)), 3);
+
+#if !defined(BOOST_NO_CXX11_HDR_FUNCTIONAL) && !defined(BOOST_NO_CXX11_HDR_UNORDERED_SET)
+	BOOST_CHECK_EQUAL(std::hash<Set2<int> >()(Set2<int>(5, 10)), hash_value(Set2<int>(5, 10)));
+	std::unordered_set<Set2<int> > stdSet;
+	stdSet.insert(Set2<int>(5, 10));
+	stdSet.insert(Set2<int>(10, 5));
+	BOOST_CHECK_EQUAL(stdSet.size(), 1);
+#endif
+}
+
 /// @todo Add tests for use in std::set
 /// @todo Add templated construction test in separate cpp
 
@@ -0,0 +1,220 @@
+/** @file
+	@brief Test Implementation
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_TEST_MODULE Set2Packed
+
+// Internal Includes
+#include <util/Set2Packed.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace boost::unit_test;
+using util::Set2;
+using util::Set2Map;
+
+BOOST_AUTO_TEST_CASE(PackRoundTrip) {
+	const int imin = std::numeric_limits<int>::min();
+	const int imax = std::numeric_limits<int>::max();
+	std::vector<Set2<int> > sets;
+	sets.push_back(Set2<int>(0, 0));
+	sets.push_back(Set2<int>(-5, 10));
+	sets.push_back(Set2<int>(imin, imax));
+	sets.push_back(Set2<int>(imax, imax));
+	sets.push_back(Set2<int>(imin, imin));
+	for (std::size_t i = 0; i < sets.size(); ++i) {
+		BOOST_CHECK(util::unpackSet2<int>(util::packSet2(sets[i])) == sets[i]);
+		BOOST_CHECK_EQUAL(util::packSet2(sets[i].second(), sets[i].first()), util::packSet2(sets[i]));
+	}
+
+	const std::uint32_t umax = std::numeric_limits<std::uint32_t>::max();
+	BOOST_CHECK(util::unpackSet2<std::uint32_t>(util::packSet2(Set2<std::uint32_t>(umax, 3))) == Set2<std::uint32_t>(3, umax));
+	BOOST_CHECK(util::unpackSet2<short>(util::packSet2(Set2<short>(-2, -7))) == Set2<short>(-7, -2));
+}
+
+BOOST_AUTO_TEST_CASE(PackOrder) {
+	std::vector<Set2<int> > sets;
+	for (int a = -3; a <= 3; ++a) {
+		for (int b = a; b <= 3; ++b) {
+			sets.push_back(Set2<int>(a, b));
+		}
+	}
+	for (std::size_t i = 0; i < sets.size(); ++i) {
+		for (std::size_t j = 0; j < sets.size(); ++j) {
+			BOOST_CHECK_EQUAL(sets[i] < sets[j], util::packSet2(sets[i]) < util::packSet2(sets[j]));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(MapInsertFind) {
+	Set2Map<int, int> m;
+	BOOST_CHECK(m.empty());
+	BOOST_CHECK(m.find(1, 2) == nullptr);
+
+	BOOST_CHECK(m.insert(Set2<int>(5, 10), 1).second);
+	BOOST_CHECK(!m.insert(Set2<int>(10, 5), 2).second);
+	m[Set2<int>(20, 30)] = 3;
+	m[Set2<int>(30, 20)] += 1;
+
+	BOOST_REQUIRE_EQUAL(m.size(), 2);
+	BOOST_REQUIRE(m.find(10, 5) != nullptr);
+	BOOST_CHECK_EQUAL(*m.find(10, 5), 1);
+	BOOST_CHECK_EQUAL(*m.find(Set2<int>(20, 30)), 4);
+	BOOST_CHECK(!m.contains(Set2<int>(5, 20)));
+
+	// The pair whose packed form is all ones must not be mistaken for an
+	// empty slot, nor may any other extreme pair.
+	const int imax = std::numeric_limits<int>::max();
+	const int imin = std::numeric_limits<int>::min();
+	m[Set2<int>(imax, imax)] = 5;
+	m[Set2<int>(imin, imin + 1)] = 6;
+	BOOST_CHECK_EQUAL(*m.find(imax, imax), 5);
+	BOOST_CHECK_EQUAL(*m.find(imin + 1, imin), 6);
+
+	Set2Map<int, int> const& cm = m;
+	BOOST_CHECK_EQUAL(*cm.find(5, 10), 1);
+}
+
+BOOST_AUTO_TEST_CASE(MapErase) {
+	Set2Map<int, int> m;
+	// Enough entries in a small table to make long probe runs.
+	for (int i = 0; i < 12; ++i) {
+		m[Set2<int>(i, 100 - i)] = i;
+	}
+	BOOST_CHECK(!m.erase(Set2<int>(1000, 1001)));
+	for (int i = 0; i < 12; i += 2) {
+		BOOST_CHECK(m.erase(Set2<int>(100 - i, i)));
+	}
+	BOOST_CHECK_EQUAL(m.size(), 6);
+	for (int i = 0; i < 12; ++i) {
+		int const* v = m.find(i, 100 - i);
+		if (i % 2) {
+			BOOST_REQUIRE(v != nullptr);
+			BOOST_CHECK_EQUAL(*v, i);
+		} else {
+			BOOST_CHECK(v == nullptr);
+		}
+	}
+	m.clear();
+	BOOST_CHECK(m.empty());
+	BOOST_CHECK(m.find(1, 99) == nullptr);
+}
+
+namespace {
+	struct Collect {
+		std::map<Set2<int>, int> * out;
+		void operator()(Set2<int> const& k, int & v) {
+			(*out)[k] = v;
+		}
+	};
+}
+
+BOOST_AUTO_TEST_CASE(MapGrowAndForEach) {
+	Set2Map<int, int> m;
+	std::map<Set2<int>, int> expected;
+	for (int i = 0; i < 1000; ++i) {
+		Set2<int> k(i * 7919 % 1000, i * 104729 % 997 - 500);
+		m[k] = i;
+		expected[k] = i;
+	}
+	BOOST_CHECK_EQUAL(m.size(), expected.size());
+	BOOST_CHECK(m.capacity() * 3 >= m.size() * 4);
+
+	std::map<Set2<int>, int> actual;
+	Collect c = {&actual};
+	m.forEach(c);
+	BOOST_CHECK(actual == expected);
+
+	Set2Map<int, int> reserved;
+	reserved.reserve(1000);
+	const std::size_t cap = reserved.capacity();
+	for (int i = 0; i < 1000; ++i) {
+		reserved[Set2<int>(i, i + 1)] = i;
+	}
+	BOOST_CHECK_EQUAL(reserved.capacity(), cap);
+}
+
+namespace {
+	template<typename T>
+	void checkBulkPack(std::vector<T> const& ab) {
+		const std::size_t n = ab.size() / 2;
+		std::vector<std::uint64_t> keys(n);
+		util::packSet2Pairs(ab.data(), n, keys.data());
+		for (std::size_t i = 0; i < n; ++i) {
+			BOOST_CHECK_EQUAL(keys[i], util::packSet2(Set2<T>(ab[2 * i], ab[2 * i + 1])));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(BulkPack) {
+	std::mt19937 rng(1234);
+	// Odd counts exercise the scalar tail after the vectorized blocks.
+	std::vector<int> ints(2 * 37);
+	for (std::size_t i = 0; i < ints.size(); ++i) {
+		ints[i] = int(rng());
+	}
+	ints[0] = std::numeric_limits<int>::min();
+	ints[1] = std::numeric_limits<int>::max();
+	ints[2] = -1;
+	ints[3] = 0;
+	ints[4] = ints[5] = 7;
+	checkBulkPack(ints);
+
+	std::vector<std::uint32_t> uints(2 * 21);
+	for (std::size_t i = 0; i < uints.size(); ++i) {
+		uints[i] = std::uint32_t(rng());
+	}
+	uints[0] = 0x80000000u;
+	uints[1] = 0x7fffffffu;
+	checkBulkPack(uints);
+
+	std::vector<short> shorts;
+	shorts.push_back(3);
+	shorts.push_back(-4);
+	checkBulkPack(shorts);
+}
+
+BOOST_AUTO_TEST_CASE(SortUnique) {
+	std::mt19937 rng(99);
+	std::vector<int> ab;
+	std::set<Set2<int> > expected;
+	for (int i = 0; i < 5000; ++i) {
+		// Mostly small indices, so high digits are skipped, plus some
+		// negative and large values so they are not.
+		int a = int(rng() % 200);
+		int b = (i % 10 == 0) ? int(rng()) : int(rng() % 200) - 20;
+		ab.push_back(a);
+		ab.push_back(b);
+		expected.insert(Set2<int>(a, b));
+	}
+	std::vector<std::uint64_t> keys = util::uniqueSet2Keys(ab.data(), ab.size() / 2);
+	BOOST_REQUIRE_EQUAL(keys.size(), expected.size());
+	std::vector<Set2<int> > sets(keys.size());
+	util::unpackSet2Keys(keys.data(), keys.size(), sets.data());
+	BOOST_CHECK(std::equal(sets.begin(), sets.end(), expected.begin()));
+
+	std::vector<std::uint64_t> none;
+	util::sortUniqueSet2Keys(none);
+	BOOST_CHECK(none.empty());
+}
@@ -0,0 +1,122 @@
+/** @file
+	@brief Test Implementation
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_TEST_MODULE SplitMap
+
+// Internal Includes
+#include <util/SplitMap.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef UTIL_SPLITMAP_HAVE_CXX11
+#include <memory>
+#endif
+
+using namespace boost::unit_test;
+
+typedef std::map<int, std::string> IntStringMap;
+
+namespace {
+	IntStringMap makeMap() {
+		IntStringMap m;
+		m[3] = "three";
+		m[1] = "one";
+		m[2] = "two";
+		return m;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ExplicitTypes) {
+	IntStringMap m = makeMap();
+	std::vector<int> keys = util::getAllKeys<IntStringMap, std::vector<int> >(m);
+	std::list<std::string> values = util::getAllValues<IntStringMap, std::list<std::string> >(m);
+	std::pair<std::vector<int>, std::vector<std::string> > split =
+	    util::getSplit<IntStringMap, std::pair<std::vector<int>, std::vector<std::string> > >(m);
+
+	BOOST_REQUIRE_EQUAL(keys.size(), 3);
+	BOOST_CHECK_EQUAL(keys[0], 1);
+	BOOST_CHECK_EQUAL(keys[2], 3);
+	BOOST_REQUIRE_EQUAL(values.size(), 3);
+	BOOST_CHECK_EQUAL(values.front(), "one");
+	BOOST_CHECK(split.first == keys);
+	BOOST_CHECK_EQUAL(split.second[1], "two");
+	// The source is untouched.
+	BOOST_CHECK_EQUAL(m[3], "three");
+}
+
+BOOST_AUTO_TEST_CASE(DefaultTypes) {
+	IntStringMap const m = makeMap();
+	std::vector<int> keys = util::getAllKeys(m);
+	std::vector<std::string> values = util::getAllValues(m);
+	BOOST_CHECK_GE(keys.capacity(), m.size());
+	BOOST_CHECK_GE(values.capacity(), m.size());
+	BOOST_CHECK_EQUAL(values[2], "three");
+
+	std::pair<std::vector<int>, std::vector<std::string> > split = util::getSplit(m);
+	BOOST_CHECK(split.first == keys);
+	BOOST_CHECK(split.second == values);
+}
+
+#ifdef UTIL_SPLITMAP_HAVE_CXX11
+BOOST_AUTO_TEST_CASE(MoveFromRvalue) {
+	typedef std::map<int, std::unique_ptr<int> > OwningMap;
+	OwningMap m;
+	m[1].reset(new int(10));
+	m[2].reset(new int(20));
+	int * raw = m[2].get();
+	std::vector<std::unique_ptr<int> > values = util::getAllValues(std::move(m));
+	BOOST_REQUIRE_EQUAL(values.size(), 2);
+	BOOST_CHECK_EQUAL(values[1].get(), raw);
+	BOOST_CHECK_EQUAL(*values[0], 10);
+
+	// Keys are moved out of a flat "map" too.
+	typedef std::vector<std::pair<std::string, std::string> > FlatMap;
+	FlatMap flat;
+	flat.push_back(std::make_pair(std::string(100, 'k'), std::string(100, 'v')));
+	const char * keyData = flat[0].first.data();
+	std::vector<std::string> keys;
+	std::vector<std::string> vals;
+	util::splitInto(std::move(flat), std::back_inserter(keys), std::back_inserter(vals));
+	BOOST_CHECK_EQUAL(keys[0].data(), keyData);
+	BOOST_CHECK_EQUAL(vals[0], std::string(100, 'v'));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(OutputIterators) {
+	IntStringMap m = makeMap();
+	int keys[3];
+	std::string values[3];
+	BOOST_CHECK(util::copyKeys(m, keys) == keys + 3);
+	BOOST_CHECK(util::copyValues(m, values) == values + 3);
+	BOOST_CHECK_EQUAL(keys[1], 2);
+	BOOST_CHECK_EQUAL(values[1], "two");
+
+	int keys2[3];
+	std::string values2[3];
+	std::pair<int *, std::string *> ends = util::splitInto(m, keys2, values2);
+	BOOST_CHECK(ends.first == keys2 + 3);
+	BOOST_CHECK(ends.second == values2 + 3);
+	BOOST_CHECK_EQUAL(keys2[2], 3);
+	BOOST_CHECK_EQUAL(values2[0], "one");
+}
@@ -0,0 +1,51 @@
+/** @file
+	@brief Test Implementation
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_TEST_MODULE SplitMapParallel
+
+// Internal Includes
+#include <util/SplitMapParallel.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <utility>
+#include <vector>
+
+using namespace boost::unit_test;
+
+BOOST_AUTO_TEST_CASE(ParallelSplit) {
+	typedef std::vector<std::pair<int, double> > FlatMap;
+	FlatMap flat;
+	const int n = 100000;
+	for (int i = 0; i < n; ++i) {
+		flat.push_back(std::make_pair(i, i * 0.5));
+	}
+	std::vector<int> keys(n);
+	std::vector<double> values(n);
+	util::splitParallel(flat, keys.begin(), values.begin(), 4);
+	for (int i = 0; i < n; ++i) {
+		BOOST_REQUIRE_EQUAL(keys[i], i);
+		BOOST_REQUIRE_EQUAL(values[i], i * 0.5);
+	}
+
+	// Small inputs, including empty ones, stay on the calling thread.
+	FlatMap small(flat.begin(), flat.begin() + 10);
+	util::splitParallel(small, keys.begin(), values.begin());
+	util::splitParallel(FlatMap(), keys.begin(), values.begin());
+	BOOST_CHECK_EQUAL(keys[9], 9);
+}
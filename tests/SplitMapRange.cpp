@@ -0,0 +1,45 @@
+/** @file
+	@brief Test Implementation
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_TEST_MODULE SplitMapRange
+
+// Internal Includes
+#include <util/SplitMapRange.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <map>
+#include <string>
+
+using namespace boost::unit_test;
+
+BOOST_AUTO_TEST_CASE(LazyViews) {
+	std::map<int, std::string> m;
+	m[3] = "three";
+	m[1] = "one";
+	m[2] = "two";
+	int expectedKey = 1;
+	for (int const& k : util::keysOf(m)) {
+		BOOST_CHECK_EQUAL(k, expectedKey++);
+	}
+	for (std::string & v : util::valuesOf(m)) {
+		v += "!";
+	}
+	BOOST_CHECK_EQUAL(m[1], "one!");
+	BOOST_CHECK_EQUAL(boost::size(util::keysOf(m)), 3);
+}
@@ -19,6 +19,8 @@
 #include <set>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace boost::unit_test;
 
@@ -28,6 +30,8 @@ typedef std::set<util::TypeId> TypeIdSet;
 
 typedef std::pair<util::TypeId, int> TypeIdPair;
 typedef std::map<util::TypeId, int> TypeIdMap;
+typedef std::unordered_set<util::TypeId> TypeIdHashSet;
+typedef std::unordered_map<util::TypeId, int> TypeIdHashMap;
 
 struct Fixture {
 	Fixture() : StringId(typeid(std::string)), IntId(typeid(int)) {}
@@ -217,3 +221,51 @@ BOOST_AUTO_TEST_CASE(TransitivityOfOrderingAndEquality) {
 		}
 	}
 }
+
+BOOST_AUTO_TEST_CASE(HashCode) {
+	Fixture f;
+	BOOST_CHECK_EQUAL(f.IntId.hash_code(), typeid(int).hash_code());
+	BOOST_CHECK_EQUAL(f.IntId.hash_code(), TypeId::create<int>().hash_code());
+	BOOST_CHECK_EQUAL(f.EmptyId.hash_code(), TypeId().hash_code());
+	BOOST_CHECK_EQUAL(std::hash<TypeId>()(f.StringId), f.StringId.hash_code());
+	BOOST_CHECK_EQUAL(hash_value(f.StringId), f.StringId.hash_code());
+}
+
+BOOST_AUTO_TEST_CASE(UnorderedContainers) {
+	Fixture f;
+	TypeIdHashSet set;
+	set.insert(f.EmptyId);
+	set.insert(f.IntId);
+	set.insert(f.StringId);
+	set.insert(TypeId::create<int>());
+	BOOST_CHECK_EQUAL(set.size(), 3);
+	BOOST_CHECK(set.count(TypeId(typeid(std::string))) == 1);
+	BOOST_CHECK(set.count(TypeId::create<double>()) == 0);
+
+	TypeIdHashMap map;
+	map[f.IntId] = 1;
+	map[f.StringId] = 2;
+	BOOST_CHECK_EQUAL(map.at(TypeId::create<int>()), 1);
+	BOOST_CHECK_EQUAL(map.at(TypeId(typeid(std::string))), 2);
+	BOOST_CHECK(map.find(f.EmptyId) == map.end());
+}
+
+BOOST_AUTO_TEST_CASE(StaticTypeIds) {
+	using util::StaticTypeId;
+	static_assert(StaticTypeId::create<int>() == StaticTypeId::create<int>(), "Same type, same id");
+	static_assert(StaticTypeId::create<int>() != StaticTypeId::create<float>(), "Different types, different ids");
+	static_assert(StaticTypeId().empty(), "Default-constructed id is empty");
+
+	const StaticTypeId intId = StaticTypeId::create<int>();
+	BOOST_CHECK(!intId.empty());
+	BOOST_CHECK(intId != StaticTypeId());
+	BOOST_CHECK(intId < StaticTypeId::create<std::string>() || StaticTypeId::create<std::string>() < intId);
+	BOOST_CHECK(!(intId < intId));
+
+	std::unordered_map<StaticTypeId, int> map;
+	map[intId] = 1;
+	map[StaticTypeId::create<std::string>()] = 2;
+	BOOST_CHECK_EQUAL(map.at(StaticTypeId::create<int>()), 1);
+	BOOST_CHECK_EQUAL(map.at(StaticTypeId::create<std::string>()), 2);
+	BOOST_CHECK_EQUAL(map.size(), 2);
+}
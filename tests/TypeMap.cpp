@@ -0,0 +1,224 @@
+/** @file
+	@brief Test Implementation
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_TEST_MODULE TypeMap
+
+// Internal Includes
+#include <util/TypeMap.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace boost::unit_test;
+
+using util::TypeId;
+using util::TypeMap;
+
+namespace {
+	struct Position {};
+	struct Velocity {};
+	struct Health {};
+	struct RuntimeOnly {};
+}
+
+BOOST_AUTO_TEST_CASE(DenseIndices) {
+	const std::size_t pos = util::typeMapIndex<Position>();
+	const std::size_t vel = util::typeMapIndex<Velocity>();
+	BOOST_CHECK_NE(pos, vel);
+	BOOST_CHECK_EQUAL(pos, util::typeMapIndex<Position>());
+}
+
+BOOST_AUTO_TEST_CASE(StaticAccess) {
+	TypeMap<int> map;
+	BOOST_CHECK(map.empty());
+	BOOST_CHECK(map.find<Position>() == nullptr);
+
+	map.get<Position>() = 1;
+	map.get<Velocity>() = 2;
+	BOOST_CHECK_EQUAL(map.size(), 2);
+	BOOST_REQUIRE(map.find<Position>() != nullptr);
+	BOOST_CHECK_EQUAL(*map.find<Position>(), 1);
+	BOOST_CHECK_EQUAL(map.get<Velocity>(), 2);
+	BOOST_CHECK(!map.contains<Health>());
+
+	TypeMap<int> const& cmap = map;
+	BOOST_CHECK_EQUAL(*cmap.find<Velocity>(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(RuntimeAccess) {
+	TypeMap<std::string> map;
+	map.get(typeid(RuntimeOnly)) = "runtime";
+	map.get(TypeId::create<int>()) = "int";
+	BOOST_CHECK_EQUAL(map.size(), 2);
+	BOOST_REQUIRE(map.find(typeid(RuntimeOnly)) != nullptr);
+	BOOST_CHECK_EQUAL(*map.find(typeid(RuntimeOnly)), "runtime");
+	BOOST_CHECK(map.contains(typeid(int)));
+	BOOST_CHECK(!map.contains(typeid(double)));
+}
+
+BOOST_AUTO_TEST_CASE(MixedAccess) {
+	TypeMap<std::string> map;
+	// Inserted statically, found at runtime.
+	map.get<Position>() = "position";
+	BOOST_REQUIRE(map.find(typeid(Position)) != nullptr);
+	BOOST_CHECK_EQUAL(map.get(typeid(Position)), "position");
+
+	// Inserted at runtime, then moved to the dense storage on static access.
+	map.get(typeid(Health)) = "health";
+	BOOST_CHECK_EQUAL(*map.find<Health>(), "health");
+	BOOST_CHECK_EQUAL(map.get<Health>(), "health");
+	BOOST_CHECK_EQUAL(*map.find(typeid(Health)), "health");
+	BOOST_CHECK_EQUAL(map.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Erase) {
+	TypeMap<int> map;
+	map.get<Position>() = 1;
+	map.get(typeid(RuntimeOnly)) = 2;
+	BOOST_CHECK(map.erase<Position>());
+	BOOST_CHECK(!map.erase<Position>());
+	BOOST_CHECK(map.find<Position>() == nullptr);
+	BOOST_CHECK(map.find(typeid(Position)) == nullptr);
+	BOOST_CHECK(map.erase(typeid(RuntimeOnly)));
+	BOOST_CHECK(map.empty());
+
+	map.get<Position>() = 3;
+	map.clear();
+	BOOST_CHECK(map.empty());
+	BOOST_CHECK(!map.contains<Position>());
+}
+
+namespace {
+	template<int N>
+	struct Tag {};
+}
+
+BOOST_AUTO_TEST_CASE(StableReferences) {
+	TypeMap<int> map;
+	int & first = map.get<Tag<0> >();
+	int & runtime = map.get(typeid(Tag<1>));
+	int * runtimePtr = map.find(typeid(Tag<1>));
+	// Enough new types to grow the dense storage several times, and move
+	// the runtime entry into it.
+	map.get<Tag<2> >() = 2;
+	map.get<Tag<3> >() = 3;
+	map.get<Tag<4> >() = 4;
+	map.get<Tag<5> >() = 5;
+	map.get<Tag<6> >() = 6;
+	map.get<Tag<7> >() = 7;
+	map.get<Tag<8> >() = 8;
+	map.get<Tag<1> >();
+	first = 10;
+	runtime = 11;
+	BOOST_CHECK_EQUAL(map.get<Tag<0> >(), 10);
+	BOOST_CHECK_EQUAL(map.get<Tag<1> >(), 11);
+	BOOST_CHECK_EQUAL(&map.get<Tag<1> >(), runtimePtr);
+	BOOST_CHECK_EQUAL(map.size(), 9);
+}
+
+namespace {
+	struct Summer {
+		int * sum;
+		std::size_t * count;
+		void operator()(TypeId const&, int & v) {
+			*sum += v;
+			++*count;
+		}
+	};
+}
+
+BOOST_AUTO_TEST_CASE(ForEach) {
+	TypeMap<int> map;
+	map.get<Position>() = 1;
+	map.get<Velocity>() = 10;
+	map.get(typeid(RuntimeOnly)) = 100;
+	int sum = 0;
+	std::size_t count = 0;
+	Summer s = {&sum, &count};
+	map.forEach(s);
+	BOOST_CHECK_EQUAL(sum, 111);
+	BOOST_CHECK_EQUAL(count, 3);
+}
+
+namespace {
+	/// Counts live instances, and can be made to throw on construction.
+	struct Counted {
+		static int live;
+		static bool throwOnConstruct;
+		Counted() {
+			if (throwOnConstruct) {
+				throw std::runtime_error("construction failed");
+			}
+			++live;
+		}
+		~Counted() {
+			--live;
+		}
+	};
+	int Counted::live = 0;
+	bool Counted::throwOnConstruct = false;
+}
+
+BOOST_AUTO_TEST_CASE(ThrowingConstructor) {
+	TypeMap<Counted> map;
+	Counted::throwOnConstruct = true;
+	BOOST_CHECK_THROW(map.get(typeid(RuntimeOnly)), std::runtime_error);
+	BOOST_CHECK_THROW(map.get<Position>(), std::runtime_error);
+	Counted::throwOnConstruct = false;
+	BOOST_CHECK(map.empty());
+	BOOST_CHECK(!map.contains(typeid(RuntimeOnly)));
+	BOOST_CHECK(!map.contains<Position>());
+	std::size_t count = 0;
+	map.forEach([&](TypeId const&, Counted &) {
+		++count;
+	});
+	BOOST_CHECK_EQUAL(count, 0);
+	BOOST_CHECK_EQUAL(Counted::live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ValueLifetime) {
+	{
+		TypeMap<Counted> map;
+		Counted * position = &map.get<Position>();
+		map.get<Velocity>();
+		map.get(typeid(RuntimeOnly));
+		BOOST_CHECK_EQUAL(Counted::live, 3);
+
+		// Erasing destroys the value, and its slot is reused.
+		BOOST_CHECK(map.erase<Position>());
+		BOOST_CHECK_EQUAL(Counted::live, 2);
+		BOOST_CHECK_EQUAL(&map.get<Health>(), position);
+
+		// Moving the map keeps the values in place.
+		TypeMap<Counted> moved(std::move(map));
+		BOOST_CHECK(map.empty());
+		BOOST_CHECK_EQUAL(moved.size(), 3);
+		BOOST_CHECK_EQUAL(moved.find<Health>(), position);
+		BOOST_CHECK_EQUAL(Counted::live, 3);
+
+		map = std::move(moved);
+		BOOST_CHECK_EQUAL(map.find<Health>(), position);
+		map.clear();
+		BOOST_CHECK_EQUAL(Counted::live, 0);
+		map.get<Position>();
+	}
+	BOOST_CHECK_EQUAL(Counted::live, 0);
+}
@@ -20,15 +20,55 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <tuple>
 
 
 using namespace boost::unit_test;
 using namespace util;
+
+enum Layout { ArrayOfStructs = 3, StructOfArrays = 7 };
+
+namespace util {
+	template<>
+	struct DefaultValueToTemplatePolicy<Layout> : ValueSetSelectionPolicy<Layout, ArrayOfStructs, StructOfArrays> {};
+}
+/// A type whose policy only has a template parameter for 0, and does not
+/// throw for other values.
+struct Lenient {
+	int value;
+};
+
+namespace util {
+	template<>
+	struct DefaultValueToTemplatePolicy<Lenient> {
+		enum {
+			size = 1
+		};
+
+		template<std::size_t I>
+		struct at {
+			typedef boost::mpl::int_<0> type;
+		};
+
+		static inline std::size_t index(Lenient const& val) {
+			return val.value == 0 ? 0 : 1;
+		}
+
+		static inline void outOfRange(Lenient const&) {}
+	};
+}
 using boost::tuple;
 using boost::make_tuple;
 using std::string;
 namespace mpl = boost::mpl;
 
+struct Generic {
+	template<typename Tuple>
+	int operator()(Tuple const&) const {
+		return -1;
+	}
+};
+
 struct Metafunc {
 	typedef int result_type;
 	template<typename Seq>
@@ -50,3 +90,52 @@ BOOST_AUTO_TEST_CASE(BoolsAndInts) {
 BOOST_AUTO_TEST_CASE(RangedInts) {
 	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(boost::make_tuple(util::RangedInt<20, 30>(25), util::RangedInt < -30, -20 > (-25), util::RangedInt < -5, 5 > (3)))), 3);
 }
+
+BOOST_AUTO_TEST_CASE(AllCombinations) {
+	for (int i = 0; i <= 10; ++i) {
+		for (int j = 0; j <= 10; ++j) {
+			BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(boost::make_tuple(i, j, true))), i + j + 1);
+			BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(boost::make_tuple(util::RangedInt < -3, 3 > (j % 7 - 3), i, false))), j % 7 - 3 + i);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(OutOfRange) {
+	BOOST_CHECK_THROW((util::ValueToTemplate<Metafunc>(boost::make_tuple(11, false, 3))), std::runtime_error);
+	BOOST_CHECK_THROW((util::ValueToTemplate<Metafunc>(boost::make_tuple(1, false, -1))), std::runtime_error);
+	BOOST_CHECK_THROW((util::ValueToTemplate<Metafunc>(boost::make_tuple(util::RangedInt<20, 30, NeverCheck>(31), false, 0))), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(OutOfRangeNotReported) {
+	Lenient zero = {0};
+	Lenient five = {5};
+	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(boost::make_tuple(zero, 1, 2))), 3);
+	BOOST_CHECK_THROW((util::ValueToTemplate<Metafunc>(boost::make_tuple(five, 1, 2))), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(StdTuple) {
+	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(std::make_tuple(5, false, 3))), 8);
+	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(std::make_tuple(true, util::RangedInt < -5, 5 > (-4), 10))), 7);
+	BOOST_CHECK_THROW((util::ValueToTemplate<Metafunc>(std::make_tuple(5, false, 11))), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ValueSets) {
+	typedef ValueSet<int, 1, 2, 4, 8> PowerOfTwo;
+	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(boost::make_tuple(PowerOfTwo(8), false, 1))), 9);
+	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(boost::make_tuple(PowerOfTwo(1), PowerOfTwo(4), PowerOfTwo(2)))), 7);
+	BOOST_CHECK_THROW((util::ValueToTemplate<Metafunc>(boost::make_tuple(PowerOfTwo(3), false, 1))), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Enums) {
+	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(boost::make_tuple(StructOfArrays, true, 0))), 8);
+	BOOST_CHECK_EQUAL((util::ValueToTemplate<Metafunc>(std::make_tuple(ArrayOfStructs, false, ValueSet<Layout, StructOfArrays>(StructOfArrays)))), 10);
+	BOOST_CHECK_THROW((util::ValueToTemplate<Metafunc>(boost::make_tuple(Layout(0), true, 0))), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Fallback) {
+	BOOST_CHECK_EQUAL((util::ValueToTemplateWithFallback<Metafunc>(boost::make_tuple(5, false, 3), Generic())), 8);
+	BOOST_CHECK_EQUAL((util::ValueToTemplateWithFallback<Metafunc>(boost::make_tuple(5, false, 11), Generic())), -1);
+	BOOST_CHECK_EQUAL((util::ValueToTemplateWithFallback<Metafunc>(std::make_tuple(-1, true, 0), Generic())), -1);
+	BOOST_CHECK_EQUAL((util::ValueToTemplateWithFallback<Metafunc>(boost::make_tuple(Layout(1), true, ValueSet<int, 2, 3>(3)), Generic())), -1);
+	BOOST_CHECK_EQUAL((util::ValueToTemplateWithFallback<Metafunc>(boost::make_tuple(Layout(3), true, ValueSet<int, 2, 3>(3)), Generic())), 7);
+}
@@ -0,0 +1,123 @@
+/**
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+#define BOOST_TEST_MODULE VoxelCaseClassifier tests
+
+// Internal Includes
+#include <util/VoxelCaseClassifier.h>
+
+// Library/third-party includes
+#include <BoostTestTargetConfig.h>
+
+// Standard includes
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+
+using namespace boost::unit_test;
+using namespace util;
+
+/// Distance from the center of the grid, minus a little noise so some
+/// points land exactly on the iso value.
+static std::vector<float> makeSphereField(std::size_t nx, std::size_t ny, std::size_t nz) {
+	std::vector<float> field(nx * ny * nz);
+	for (std::size_t z = 0; z < nz; ++z) {
+		for (std::size_t y = 0; y < ny; ++y) {
+			for (std::size_t x = 0; x < nx; ++x) {
+				float dx = x - nx / 2.f, dy = y - ny / 2.f, dz = z - nz / 2.f;
+				field[x + nx * (y + ny * z)] = std::floor(std::sqrt(dx * dx + dy * dy + dz * dz) * 2) / 2;
+			}
+		}
+	}
+	return field;
+}
+
+/// Per-cell classification through the vertex tables.
+static std::vector<std::uint8_t> referenceCases(std::vector<float> const& field, std::size_t nx, std::size_t ny, std::size_t nz, float iso) {
+	std::vector<std::uint8_t> cases;
+	for (std::size_t z = 0; z + 1 < nz; ++z) {
+		for (std::size_t y = 0; y + 1 < ny; ++y) {
+			for (std::size_t x = 0; x + 1 < nx; ++x) {
+				std::uint8_t c = 0;
+				for (std::uint8_t v = 0; v < 8; ++v) {
+					std::size_t px = x + (CubeComponents::vertexCoordinate(v, 0) > 0);
+					std::size_t py = y + (CubeComponents::vertexCoordinate(v, 1) > 0);
+					std::size_t pz = z + (CubeComponents::vertexCoordinate(v, 2) > 0);
+					if (field[px + nx * (py + ny * pz)] < iso) {
+						c |= 1 << v;
+					}
+				}
+				cases.push_back(c);
+			}
+		}
+	}
+	return cases;
+}
+
+BOOST_AUTO_TEST_CASE(EmptyGrid) {
+	VoxelCaseClassifier classifier(1, 5, 5);
+	BOOST_CHECK_EQUAL(classifier.cellCount(), 0);
+	std::vector<float> field(25);
+	BOOST_CHECK_NO_THROW(classifier.classify(&(field[0]), 0.f, NULL));
+	std::vector<VoxelEdgeIntersection> hits;
+	BOOST_CHECK_NO_THROW(classifier.findEdgeIntersections(&(field[0]), 0.f, NULL, hits));
+	BOOST_CHECK(hits.empty());
+}
+
+BOOST_AUTO_TEST_CASE(ClassifyMatchesReference) {
+	// Odd sizes exercise both the vector loops and the scalar remainders.
+	const std::size_t sizes[][3] = {{2, 2, 2}, {17, 3, 4}, {50, 21, 13}, {71, 9, 30}};
+	const unsigned threadCounts[] = {1, 3, 8};
+	for (std::size_t s = 0; s < 4; ++s) {
+		std::size_t nx = sizes[s][0], ny = sizes[s][1], nz = sizes[s][2];
+		std::vector<float> field = makeSphereField(nx, ny, nz);
+		std::vector<std::uint8_t> expected = referenceCases(field, nx, ny, nz, 3.f);
+		for (std::size_t t = 0; t < 3; ++t) {
+			VoxelCaseClassifier classifier(nx, ny, nz, threadCounts[t]);
+			BOOST_REQUIRE_EQUAL(classifier.cellCount(), expected.size());
+			std::vector<std::uint8_t> cases(classifier.cellCount(), 0xAA);
+			classifier.classify(&(field[0]), 3.f, &(cases[0]));
+			BOOST_CHECK(cases == expected);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(EdgeIntersections) {
+	const std::size_t nx = 20, ny = 18, nz = 16;
+	std::vector<float> field = makeSphereField(nx, ny, nz);
+	const float iso = 5.25f;
+	VoxelCaseClassifier classifier(nx, ny, nz, 4);
+	std::vector<std::uint8_t> cases(classifier.cellCount());
+	classifier.classify(&(field[0]), iso, &(cases[0]));
+
+	std::vector<VoxelEdgeIntersection> hits;
+	classifier.findEdgeIntersections(&(field[0]), iso, &(cases[0]), hits);
+
+	std::size_t expectedCount = 0;
+	for (std::size_t c = 0; c < cases.size(); ++c) {
+		for (unsigned mask = CubeComponents::caseEdgeMask(cases[c]); mask; mask >>= 1) {
+			expectedCount += mask & 1;
+		}
+	}
+	BOOST_REQUIRE_EQUAL(hits.size(), expectedCount);
+	BOOST_REQUIRE(!hits.empty());
+
+	for (std::size_t i = 0; i < hits.size(); ++i) {
+		VoxelEdgeIntersection const& hit = hits[i];
+		if (i > 0) {
+			BOOST_CHECK(hits[i - 1].cell <= hit.cell);
+		}
+		BOOST_CHECK(CubeComponents::caseEdgeMask(cases[hit.cell]) & (1 << hit.edge));
+		BOOST_CHECK(hit.t >= 0.f && hit.t <= 1.f);
+		BOOST_CHECK_EQUAL(hit.edgeKey % 3, hit.edge / 4u);
+		// Linear interpolation along the edge should give back the iso value.
+		std::size_t a = hit.edgeKey / 3;
+		std::size_t b = a + (hit.edge / 4 == 0 ? 1 : hit.edge / 4 == 1 ? nx : nx * ny);
+		BOOST_CHECK_CLOSE(field[a] + hit.t * (field[b] - field[a]), iso, 0.001);
+	}
+}
@@ -0,0 +1,75 @@
+/** @file
+	@brief Benchmark of util::FusionMapToTemplate: dispatches over a map of
+	three ints and a bool (11 * 11 * 11 * 2 = 2662 instantiations).
+
+	Build the benchmark_FusionMapToTemplateDispatch target to see how long
+	the translation unit takes to compile and how large the binary is, then
+	run it to measure the cost of each dispatch.
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Internal Includes
+#include <util/FusionMapToTemplate.h>
+
+// Library/third-party includes
+#include <boost/mpl/at.hpp>
+
+// Standard includes
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+struct Width;
+struct Height;
+struct Depth;
+struct Normals;
+
+typedef boost::fusion::map <
+boost::fusion::pair<Width, int>,
+      boost::fusion::pair<Height, int>,
+      boost::fusion::pair<Depth, int>,
+      boost::fusion::pair<Normals, bool> > Params;
+
+struct Kernel {
+	typedef int result_type;
+	template<typename Map>
+	static int apply() {
+		return boost::mpl::at<Map, Width>::type::value * 1000
+		       + boost::mpl::at<Map, Height>::type::value * 100
+		       + boost::mpl::at<Map, Depth>::type::value * 10
+		       + boost::mpl::at<Map, Normals>::type::value;
+	}
+};
+
+int main() {
+	std::vector<int> values(4096);
+	for (std::size_t i = 0; i < values.size(); ++i) {
+		values[i] = std::rand() % 2662;
+	}
+	const int iterations = 10000000;
+	long long sum = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		int v = values[i & 4095];
+		sum += util::FusionMapToTemplate<Kernel>(Params(
+		           boost::fusion::make_pair<Width>(v % 11),
+		           boost::fusion::make_pair<Height>((v / 11) % 11),
+		           boost::fusion::make_pair<Depth>((v / 121) % 11),
+		           boost::fusion::make_pair<Normals>((v / 1331) != 0)));
+	}
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "Random parameters: " << elapsed.count() / iterations << " ns per dispatch (checksum " << sum << ")" << std::endl;
+	return 0;
+}
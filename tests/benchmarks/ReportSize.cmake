@@ -0,0 +1,12 @@
+# Script to print the size of a file, used to report benchmark binary sizes.
+# Usage: cmake -DFILE=<path> -P ReportSize.cmake
+
+if(NOT CMAKE_VERSION VERSION_LESS 3.14)
+	file(SIZE "${FILE}" _size)
+else()
+	file(READ "${FILE}" _hex HEX)
+	string(LENGTH "${_hex}" _size)
+	math(EXPR _size "${_size} / 2")
+endif()
+get_filename_component(_name "${FILE}" NAME)
+message(STATUS "${_name}: ${_size} bytes")
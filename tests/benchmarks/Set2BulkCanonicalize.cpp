@@ -0,0 +1,88 @@
+/** @file
+	@brief Benchmark of turning broadphase output - unordered pairs of body
+	indices, with duplicates - into a sorted list of distinct util::Set2
+	pairs: per-pair construction and std::sort, against the bulk packed-key
+	functions in Set2Packed.h.
+
+	Build the benchmark_Set2BulkCanonicalize target and run it.
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Internal Includes
+#include <util/Set2Packed.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+typedef util::Set2<int> Pair;
+typedef std::chrono::steady_clock Clock;
+
+namespace {
+	const int Bodies = 100000;
+	const std::size_t Pairs = 20000000;
+
+	double millisecondsSince(Clock::time_point start) {
+		std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+		return elapsed.count();
+	}
+} // end of anonymous namespace
+
+int main() {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> body(0, Bodies - 1);
+	std::vector<int> ab(2 * Pairs);
+	for (std::size_t i = 0; i < Pairs; ++i) {
+		// Each candidate pair is reported about twice, in either order.
+		if (i % 2 && i > 1) {
+			std::size_t j = rng() % i;
+			ab[2 * i] = ab[2 * j + 1];
+			ab[2 * i + 1] = ab[2 * j];
+		} else {
+			ab[2 * i] = body(rng);
+			ab[2 * i + 1] = body(rng);
+		}
+	}
+
+	{
+		Clock::time_point start = Clock::now();
+		std::vector<Pair> sets;
+		sets.reserve(Pairs);
+		for (std::size_t i = 0; i < Pairs; ++i) {
+			sets.push_back(Pair(ab[2 * i], ab[2 * i + 1]));
+		}
+		const double construct = millisecondsSince(start);
+		std::sort(sets.begin(), sets.end());
+		sets.erase(std::unique(sets.begin(), sets.end()), sets.end());
+		std::cout << "Set2 + std::sort: " << construct << " ms to construct, "
+		          << millisecondsSince(start) << " ms total, " << sets.size() << " distinct" << std::endl;
+	}
+
+	{
+		Clock::time_point start = Clock::now();
+		std::vector<std::uint64_t> keys(Pairs);
+		util::packSet2Pairs(ab.data(), Pairs, keys.data());
+		const double pack = millisecondsSince(start);
+		util::sortUniqueSet2Keys(keys);
+		std::cout << "packSet2Pairs + radix sort: " << pack << " ms to canonicalize, "
+		          << millisecondsSince(start) << " ms total, " << keys.size() << " distinct" << std::endl;
+	}
+	return 0;
+}
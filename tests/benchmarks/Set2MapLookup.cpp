@@ -0,0 +1,109 @@
+/** @file
+	@brief Benchmark of util::Set2Map against std::map and
+	std::unordered_map keyed on util::Set2<int>, for a cache of contact
+	pairs between 16384 bodies.
+
+	Build the benchmark_Set2MapLookup target and run it to measure the cost
+	of building each container and of each lookup (half of which miss).
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Internal Includes
+#include <util/Set2Packed.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+typedef util::Set2<int> Pair;
+typedef std::chrono::steady_clock Clock;
+
+namespace {
+	const int Bodies = 16384;
+	const std::size_t Contacts = 1000000;
+	const std::size_t Lookups = 10000000;
+
+	double nanosecondsPer(Clock::time_point start, std::size_t n) {
+		std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+		return elapsed.count() / n;
+	}
+
+	template<typename Map>
+	void insertAll(Map & m, std::vector<Pair> const& pairs) {
+		for (std::size_t i = 0; i < pairs.size(); ++i) {
+			m[pairs[i]] = int(i);
+		}
+	}
+
+	template<typename Map>
+	long long lookupAll(Map const& m, std::vector<Pair> const& queries) {
+		long long sum = 0;
+		for (std::size_t i = 0; i < Lookups; ++i) {
+			typename Map::const_iterator it = m.find(queries[i % queries.size()]);
+			if (it != m.end()) {
+				sum += it->second;
+			}
+		}
+		return sum;
+	}
+
+	long long lookupAll(util::Set2Map<int, int> const& m, std::vector<Pair> const& queries) {
+		long long sum = 0;
+		for (std::size_t i = 0; i < Lookups; ++i) {
+			int const* v = m.find(queries[i % queries.size()]);
+			if (v) {
+				sum += *v;
+			}
+		}
+		return sum;
+	}
+
+	template<typename Map>
+	void run(const char * name, std::vector<Pair> const& pairs, std::vector<Pair> const& queries) {
+		Map m;
+		Clock::time_point start = Clock::now();
+		insertAll(m, pairs);
+		const double insert = nanosecondsPer(start, pairs.size());
+		start = Clock::now();
+		const long long sum = lookupAll(m, queries);
+		const double lookup = nanosecondsPer(start, Lookups);
+		std::cout << name << ": " << insert << " ns per insert, " << lookup
+		          << " ns per lookup (checksum " << sum << ")" << std::endl;
+	}
+} // end of anonymous namespace
+
+int main() {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> body(0, Bodies - 1);
+	std::vector<Pair> pairs(Contacts);
+	for (std::size_t i = 0; i < Contacts; ++i) {
+		pairs[i] = Pair(body(rng), body(rng));
+	}
+	std::vector<Pair> queries(1 << 20);
+	for (std::size_t i = 0; i < queries.size(); ++i) {
+		queries[i] = (i % 2) ? pairs[rng() % Contacts] : Pair(body(rng), body(rng));
+	}
+
+	run<std::map<Pair, int> >("std::map", pairs, queries);
+	run<std::unordered_map<Pair, int> >("std::unordered_map", pairs, queries);
+	run<util::Set2Map<int, int> >("util::Set2Map", pairs, queries);
+	return 0;
+}
@@ -0,0 +1,80 @@
+/** @file
+	@brief Benchmark of util::ValueToTemplate: dispatches over three int
+	parameters and a bool (11 * 11 * 11 * 2 = 2662 instantiations).
+
+	Build the benchmark_ValueToTemplateDispatch target to see how long the
+	translation unit takes to compile and how large the binary is, then run
+	it to measure the cost of each dispatch.
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Internal Includes
+#include <util/ValueToTemplate.h>
+
+// Library/third-party includes
+#include <boost/mpl/at.hpp>
+
+// Standard includes
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+struct Kernel {
+	typedef int result_type;
+	template<typename Seq>
+	static int apply() {
+		return boost::mpl::at_c<Seq, 0>::type::value * 1000
+		       + boost::mpl::at_c<Seq, 1>::type::value * 100
+		       + boost::mpl::at_c<Seq, 2>::type::value * 10
+		       + boost::mpl::at_c<Seq, 3>::type::value;
+	}
+};
+
+template<typename MakeArgs>
+void timeDispatch(const char * label, MakeArgs makeArgs) {
+	const int iterations = 10000000;
+	long long sum = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		sum += util::ValueToTemplate<Kernel>(makeArgs(i));
+	}
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << label << ": " << elapsed.count() / iterations << " ns per dispatch (checksum " << sum << ")" << std::endl;
+}
+
+struct SameArgs {
+	boost::tuple<int, int, int, bool> operator()(int) const {
+		return boost::make_tuple(3, 7, 5, true);
+	}
+};
+
+struct RandomArgs {
+	RandomArgs() : values(4096) {
+		for (std::size_t i = 0; i < values.size(); ++i) {
+			values[i] = std::rand() % 2662;
+		}
+	}
+	boost::tuple<int, int, int, bool> operator()(int i) const {
+		int v = values[i & 4095];
+		return boost::make_tuple(v % 11, (v / 11) % 11, (v / 121) % 11, (v / 1331) != 0);
+	}
+	std::vector<int> values;
+};
+
+int main() {
+	timeDispatch("Same parameters every call", SameArgs());
+	timeDispatch("Random parameters", RandomArgs());
+	return 0;
+}
@@ -0,0 +1,336 @@
+/** @file
+	@brief Header providing a thread-safe, sharded variant of
+	CountedUniqueValues.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_ConcurrentCountedUniqueValues_h_GUID_8bd09ce5_341e_43fd_9e82_7f85f80692ca
+#define INCLUDED_ConcurrentCountedUniqueValues_h_GUID_8bd09ce5_341e_43fd_9e82_7f85f80692ca
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace util {
+
+	namespace detail {
+		/// @internal
+		/// @brief Mixes the bits of a hash value, so that the low bits (used
+		/// to pick a shard) and the remaining bits (used to pick a bucket)
+		/// are both well-distributed even for identity hashes like
+		/// std::hash<int>.
+		inline std::size_t mixHash(std::size_t h) {
+			static const std::size_t halfBits = sizeof(std::size_t) * 4;
+			h ^= h >> halfBits;
+			h *= static_cast<std::size_t>(0x9e3779b97f4a7c15ULL);
+			h ^= h >> halfBits;
+			return h;
+		}
+
+		/// @internal
+		/// @brief Index of the highest set bit: v must be nonzero.
+		inline std::size_t floorLog2(std::size_t v) {
+#if defined(__GNUC__)
+			return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(v);
+#else
+			std::size_t ret = 0;
+			while (v >>= 1) {
+				++ret;
+			}
+			return ret;
+#endif
+		}
+
+		/// @internal
+		/// @brief Append-only storage with stable element addresses, allowing
+		/// concurrent appends and concurrent reads of published elements.
+		///
+		/// Segment s holds (64 << s) elements, so elements never
+		/// move once constructed, and only a handful of segments are ever
+		/// allocated.
+		template<typename T>
+		class ConcurrentSegmentedStorage {
+			public:
+				ConcurrentSegmentedStorage() : _size(0) {
+					for (std::size_t s = 0; s < MaxSegments; ++s) {
+						_segments[s].store(NULL, std::memory_order_relaxed);
+					}
+				}
+
+				~ConcurrentSegmentedStorage() {
+					std::size_t n = _size.load(std::memory_order_acquire);
+					for (std::size_t i = 0; i < n; ++i) {
+						if (!_isHole(i)) {
+							_address(i)->~T();
+						}
+					}
+					for (std::size_t s = 0; s < MaxSegments; ++s) {
+						::operator delete(_segments[s].load(std::memory_order_relaxed));
+					}
+				}
+
+				/// @brief Claim the next index and copy-construct v there.
+				///
+				/// The caller is responsible for publishing the returned index
+				/// to other threads with release semantics.
+				std::size_t push_back(T const& v) {
+					std::size_t i = _size.fetch_add(1, std::memory_order_relaxed);
+					T * p = _address(i, true);
+					try {
+						new(p) T(v);
+					} catch (...) {
+						std::lock_guard<std::mutex> lock(_holeMutex);
+						_holes.push_back(i);
+						throw;
+					}
+					return i;
+				}
+
+				T const& operator[](std::size_t i) const {
+					return *_address(i);
+				}
+
+				std::size_t size() const {
+					return _size.load(std::memory_order_acquire);
+				}
+
+				ConcurrentSegmentedStorage(ConcurrentSegmentedStorage const&) = delete;
+				ConcurrentSegmentedStorage & operator=(ConcurrentSegmentedStorage const&) = delete;
+
+			private:
+				static const std::size_t FirstSegmentBits = 6;
+				static const std::size_t MaxSegments = sizeof(std::size_t) * 8 - FirstSegmentBits;
+
+				T * _address(std::size_t i, bool allocate = false) const {
+					std::size_t s = floorLog2((i >> FirstSegmentBits) + 1);
+					std::size_t offset = i - ((((std::size_t(1)) << s) - 1) << FirstSegmentBits);
+					T * segment = _segments[s].load(std::memory_order_acquire);
+					if (!segment && allocate) {
+						segment = _allocateSegment(s);
+					}
+					return segment + offset;
+				}
+
+				T * _allocateSegment(std::size_t s) const {
+					std::size_t n = (std::size_t(1) << s) << FirstSegmentBits;
+					T * fresh = static_cast<T *>(::operator new(sizeof(T) * n));
+					T * expected = NULL;
+					if (_segments[s].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+						return fresh;
+					}
+					// Someone else beat us to it.
+					::operator delete(fresh);
+					return expected;
+				}
+
+				bool _isHole(std::size_t i) const {
+					for (std::size_t h = 0; h < _holes.size(); ++h) {
+						if (_holes[h] == i) {
+							return true;
+						}
+					}
+					return false;
+				}
+
+				mutable std::atomic<T *> _segments[MaxSegments];
+				std::atomic<std::size_t> _size;
+				std::mutex _holeMutex;
+				std::vector<std::size_t> _holes;
+		};
+	} // end of namespace detail
+
+/// @addtogroup DataStructures Data Structures
+/// @{
+
+	/** @brief A thread-safe counterpart to CountedUniqueValues: numbers and
+		stores unique, immutable values, allowing concurrent store() and
+		operator[] calls from any number of threads.
+
+		Values are distributed over ShardCount shards by hash. Looking up a
+		value that is already stored takes no locks; storing a new value
+		locks only the shard it hashes to. Indices are dense (0, 1, 2, ...
+		in order of insertion) and stable, and the stored values never move.
+
+		Any index returned from store() (in any thread) may be passed to
+		get() or operator[] concurrently with other threads storing values.
+
+		@note size() counts every index handed out so far, which may include
+		values whose insertion by another thread is still in progress.
+		If copying a value throws, its index is left unused.
+
+		@tparam T Value type: must be copy-constructible and hashable by Hash.
+		@tparam ShardCount Number of independently-locked shards: must be a
+		power of two.
+	*/
+	template < typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>,
+	         std::size_t ShardCount = 16 >
+	class ConcurrentCountedUniqueValues {
+		public:
+			typedef T value_type;
+			typedef std::size_t count_type;
+
+			static_assert(ShardCount != 0 && (ShardCount & (ShardCount - 1)) == 0,
+			              "ShardCount must be a power of two");
+
+			explicit ConcurrentCountedUniqueValues(Hash const& hasher = Hash(), KeyEqual const& equal = KeyEqual())
+				: _hasher(hasher)
+				, _equal(equal) {
+				for (std::size_t s = 0; s < ShardCount; ++s) {
+					_shards[s].tables.push_back(std::unique_ptr<Table>(new Table(InitialTableSize)));
+					_shards[s].table.store(_shards[s].tables.back().get(), std::memory_order_release);
+				}
+			}
+
+			ConcurrentCountedUniqueValues(ConcurrentCountedUniqueValues const&) = delete;
+			ConcurrentCountedUniqueValues & operator=(ConcurrentCountedUniqueValues const&) = delete;
+
+			/// @brief Get the index of v, storing it first if it is new.
+			count_type store(value_type const& v) {
+				std::size_t h = detail::mixHash(_hasher(v));
+				Shard & shard = _shards[h & (ShardCount - 1)];
+				std::size_t bucketHash = h / ShardCount;
+
+				count_type i = 0;
+				// Lock-free fast path: value already present.
+				if (_find(*shard.table.load(std::memory_order_acquire), v, bucketHash, i)) {
+					return i;
+				}
+
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				Table * table = shard.table.load(std::memory_order_relaxed);
+				// Someone might have inserted it before we got the lock.
+				if (_find(*table, v, bucketHash, i)) {
+					return i;
+				}
+				if ((shard.count + 1) * 2 > table->size()) {
+					table = _grow(shard);
+				}
+				i = _storage.push_back(v);
+				_insert(*table, bucketHash, i);
+				++shard.count;
+				return i;
+			}
+
+			/// @brief Bounds-checked access to a stored value
+			value_type const& get(count_type const& i) const {
+				if (i >= size()) {
+					throw std::out_of_range("Index out of range for ConcurrentCountedUniqueValues!");
+				}
+				return _storage[i];
+			}
+
+			value_type const& operator[](count_type const& i) const {
+				return _storage[i];
+			}
+
+			count_type size() const {
+				return _storage.size();
+			}
+
+		private:
+			static const std::size_t InitialTableSize = 16;
+
+			/// Open-addressed (linear probing) table of index + 1, with 0
+			/// meaning empty. Slots are only ever written once, under the
+			/// shard lock, so readers can probe without locking.
+			struct Table {
+				explicit Table(std::size_t n) : mask(n - 1), slots(new std::atomic<std::size_t>[n]) {
+					for (std::size_t j = 0; j < n; ++j) {
+						slots[j].store(0, std::memory_order_relaxed);
+					}
+				}
+				std::size_t size() const {
+					return mask + 1;
+				}
+				std::size_t mask;
+				std::unique_ptr<std::atomic<std::size_t>[]> slots;
+			};
+
+			struct Shard {
+				Shard() : table(NULL), count(0) {}
+				std::atomic<Table *> table;
+				std::mutex mutex;
+				/// @name Guarded by mutex
+				/// @{
+				std::size_t count;
+				/// Current table and all retired ones: lock-free readers may
+				/// still be probing a retired table, so they live as long as
+				/// the container.
+				std::vector<std::unique_ptr<Table> > tables;
+				/// @}
+			};
+
+			bool _find(Table const& table, value_type const& v, std::size_t bucketHash, count_type & out) const {
+				for (std::size_t j = bucketHash & table.mask;; j = (j + 1) & table.mask) {
+					std::size_t slot = table.slots[j].load(std::memory_order_acquire);
+					if (slot == 0) {
+						return false;
+					}
+					if (_equal(_storage[slot - 1], v)) {
+						out = slot - 1;
+						return true;
+					}
+				}
+			}
+
+			static void _insert(Table & table, std::size_t bucketHash, count_type i) {
+				std::size_t j = bucketHash & table.mask;
+				while (table.slots[j].load(std::memory_order_relaxed) != 0) {
+					j = (j + 1) & table.mask;
+				}
+				table.slots[j].store(i + 1, std::memory_order_release);
+			}
+
+			/// Called with the shard lock held.
+			Table * _grow(Shard & shard) {
+				Table const& old = *shard.table.load(std::memory_order_relaxed);
+				std::unique_ptr<Table> bigger(new Table(old.size() * 2));
+				for (std::size_t j = 0; j < old.size(); ++j) {
+					std::size_t slot = old.slots[j].load(std::memory_order_relaxed);
+					if (slot != 0) {
+						_insert(*bigger, detail::mixHash(_hasher(_storage[slot - 1])) / ShardCount, slot - 1);
+					}
+				}
+				Table * ret = bigger.get();
+				shard.tables.push_back(std::move(bigger));
+				shard.table.store(ret, std::memory_order_release);
+				return ret;
+			}
+
+			Hash _hasher;
+			KeyEqual _equal;
+			detail::ConcurrentSegmentedStorage<value_type> _storage;
+			Shard _shards[ShardCount];
+	};
+
+/// @}
+
+} // end of namespace util
+
+#endif // INCLUDED_ConcurrentCountedUniqueValues_h_GUID_8bd09ce5_341e_43fd_9e82_7f85f80692ca
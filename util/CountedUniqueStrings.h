@@ -0,0 +1,212 @@
+/** @file
+	@brief Header providing an arena-backed string specialization of the
+	CountedUniqueValues concept.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_CountedUniqueStrings_h_GUID_5605988a_8f8f_4089_aed3_8d6e7e0a1316
+#define INCLUDED_CountedUniqueStrings_h_GUID_5605988a_8f8f_4089_aed3_8d6e7e0a1316
+
+// Internal Includes
+#include <util/booststdint.h>
+
+// Library/third-party includes
+#include <boost/utility/string_ref.hpp>
+
+// Standard includes
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace util {
+
+	namespace detail {
+		/// @internal
+		/// @brief 64-bit FNV-1a hash of a byte range: cheap, and stable across
+		/// platforms and processes.
+		inline stdint::uint64_t fnv1a(const void * data, std::size_t len) {
+			const unsigned char * bytes = static_cast<const unsigned char *>(data);
+			stdint::uint64_t h = 14695981039346656037ULL;
+			for (std::size_t i = 0; i < len; ++i) {
+				h ^= bytes[i];
+				h *= 1099511628211ULL;
+			}
+			return h;
+		}
+	} // end of namespace detail
+
+/// @addtogroup DataStructures Data Structures
+/// @{
+
+	/** @brief Numbers and stores unique strings, like
+		CountedUniqueValues<std::string>, but keeping each string only once,
+		in a bump-allocated arena, instead of in both a vector and a map.
+
+		Strings are copied (with a terminating null) into large blocks that
+		are never moved or freed until the container is destroyed, so the
+		string_ref and const char * handles returned stay valid as long as the
+		container does. The dictionary is an open-addressed table of
+		precomputed hashes and indices.
+	*/
+	class CountedUniqueStrings {
+		public:
+			typedef boost::string_ref value_type;
+			typedef std::size_t count_type;
+
+			/// @param blockSize Size in bytes of each arena block: strings
+			/// longer than this get a block of their own.
+			explicit CountedUniqueStrings(std::size_t blockSize = 64 * 1024)
+				: _table(InitialTableSize)
+				, _cursor(NULL)
+				, _remaining(0)
+				, _blockSize(blockSize) {
+			}
+
+			~CountedUniqueStrings() {
+				for (std::size_t i = 0; i < _blocks.size(); ++i) {
+					delete[] _blocks[i];
+				}
+			}
+
+			/// @brief Get the index of s, copying it into the arena first if
+			/// it is new.
+			count_type store(value_type const& s) {
+				stdint::uint64_t h = detail::fnv1a(s.data(), s.size());
+				std::size_t mask = _table.size() - 1;
+				std::size_t j = static_cast<std::size_t>(h) & mask;
+				for (; _table[j].index != 0; j = (j + 1) & mask) {
+					if (_table[j].hash == h) {
+						Entry const& e = _entries[_table[j].index - 1];
+						if (e.length == s.size() && std::memcmp(e.data, s.data(), s.size()) == 0) {
+							return _table[j].index - 1;
+						}
+					}
+				}
+
+				// Adding it
+				if ((_entries.size() + 1) * 2 > _table.size()) {
+					_grow();
+					mask = _table.size() - 1;
+					for (j = static_cast<std::size_t>(h) & mask; _table[j].index != 0; j = (j + 1) & mask) {}
+				}
+				count_type i = _entries.size();
+				Entry e;
+				e.data = _copyToArena(s);
+				e.length = s.size();
+				_entries.push_back(e);
+				_table[j].hash = h;
+				_table[j].index = i + 1;
+				return i;
+			}
+
+			/// @brief Bounds-checked access to a stored string
+			value_type get(count_type const& i) const {
+				if (i >= size()) {
+					throw std::out_of_range("Index out of range for CountedUniqueStrings!");
+				}
+				return (*this)[i];
+			}
+
+			value_type operator[](count_type const& i) const {
+				return value_type(_entries[i].data, _entries[i].length);
+			}
+
+			/// @brief Null-terminated access to a stored string
+			const char * c_str(count_type const& i) const {
+				return _entries[i].data;
+			}
+
+			count_type size() const {
+				return _entries.size();
+			}
+
+		private:
+			CountedUniqueStrings(CountedUniqueStrings const&);
+			CountedUniqueStrings & operator=(CountedUniqueStrings const&);
+
+			enum {
+				InitialTableSize = 16
+			};
+
+			struct Entry {
+				const char * data;
+				std::size_t length;
+			};
+
+			/// Open-addressed (linear probing) table slot: index is the string
+			/// index + 1, with 0 meaning empty.
+			struct Slot {
+				Slot() : hash(0), index(0) {}
+				stdint::uint64_t hash;
+				count_type index;
+			};
+
+			const char * _copyToArena(value_type const& s) {
+				std::size_t n = s.size() + 1;
+				char * dest;
+				if (n > _blockSize) {
+					dest = _newBlock(n);
+				} else {
+					if (n > _remaining) {
+						_cursor = _newBlock(_blockSize);
+						_remaining = _blockSize;
+					}
+					dest = _cursor;
+					_cursor += n;
+					_remaining -= n;
+				}
+				std::memcpy(dest, s.data(), s.size());
+				dest[s.size()] = '\0';
+				return dest;
+			}
+
+			char * _newBlock(std::size_t n) {
+				_blocks.reserve(_blocks.size() + 1);
+				char * block = new char[n];
+				_blocks.push_back(block);
+				return block;
+			}
+
+			void _grow() {
+				std::vector<Slot> bigger(_table.size() * 2);
+				std::size_t mask = bigger.size() - 1;
+				for (std::size_t k = 0; k < _table.size(); ++k) {
+					if (_table[k].index != 0) {
+						std::size_t j = static_cast<std::size_t>(_table[k].hash) & mask;
+						while (bigger[j].index != 0) {
+							j = (j + 1) & mask;
+						}
+						bigger[j] = _table[k];
+					}
+				}
+				_table.swap(bigger);
+			}
+
+			std::vector<Entry> _entries;
+			std::vector<Slot> _table;
+			std::vector<char *> _blocks;
+			char * _cursor;
+			std::size_t _remaining;
+			std::size_t _blockSize;
+	};
+
+/// @}
+
+} // end of namespace util
+
+#endif // INCLUDED_CountedUniqueStrings_h_GUID_5605988a_8f8f_4089_aed3_8d6e7e0a1316
@@ -29,11 +29,59 @@
 // - none
 
 // Standard includes
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <vector>
 #include <map>
+#include <utility>
 
 namespace util {
 
+	namespace detail {
+		/// @internal
+		/// @brief An element of a batch passed to CountedUniqueValues::store_range
+		template<typename Iterator>
+		struct BulkStoreEntry {
+			BulkStoreEntry(Iterator i, std::size_t p) : it(i), pos(p) {}
+			Iterator it;
+			std::size_t pos;
+		};
+
+		/// @internal
+		/// @brief A run of equal values in a sorted batch passed to
+		/// CountedUniqueValues::store_range, ordered by first appearance.
+		struct BulkStoreRun {
+			BulkStoreRun(std::size_t first, std::size_t b, std::size_t e) : firstPos(first), begin(b), end(e) {}
+			bool operator<(BulkStoreRun const& other) const {
+				return firstPos < other.firstPos;
+			}
+			std::size_t firstPos;
+			std::size_t begin;
+			std::size_t end;
+		};
+
+		/// @internal
+		/// @brief Orders batch entries by value, then by position in the batch.
+		template<typename Iterator>
+		struct BulkStoreEntryLess {
+			bool operator()(BulkStoreEntry<Iterator> const& a, BulkStoreEntry<Iterator> const& b) const {
+				if (*(a.it) < *(b.it)) {
+					return true;
+				} else if (*(b.it) < *(a.it)) {
+					return false;
+				}
+				return a.pos < b.pos;
+			}
+		};
+
+		/// @internal
+		/// @brief Tag type for choosing a store_range implementation at
+		/// compile time.
+		template<bool Sorted>
+		struct BulkStoreTag {};
+	} // end of namespace detail
+
 /// @addtogroup DataStructures Data Structures
 /// @{
 	/// Default policy struct for CountedUniqueValues indicating to use
@@ -45,6 +93,25 @@ namespace util {
 		};
 	};
 
+	/// Trait indicating whether a CountedUniqueValues dictionary policy
+	/// orders its keys with operator<, so values stored with it can be
+	/// sorted: specialize with value = true for your own ordered policies to
+	/// let CountedUniqueValues::store_range deduplicate large batches by
+	/// sorting them.
+	template<typename dictionary_policy>
+	struct CUVDictionaryIsOrdered {
+		enum {
+			value = false
+		};
+	};
+
+	template<>
+	struct CUVDictionaryIsOrdered<CUVMapDictionaryPolicy> {
+		enum {
+			value = true
+		};
+	};
+
 	/// A container template that numbers and stores unique, immutable values.
 	template<typename T, typename dictionary_policy = CUVMapDictionaryPolicy>
 	class CountedUniqueValues {
@@ -53,18 +120,45 @@ namespace util {
 			typedef std::vector<value_type> storage_type;
 			typedef typename storage_type::size_type count_type;
 
+			enum {
+				/// Batches passed to store_range() at least this long are
+				/// deduplicated by sorting rather than one lookup at a time,
+				/// if the dictionary is ordered.
+				BULK_THRESHOLD = 1024
+			};
+
 			count_type store(value_type const& v) {
-				count_type i = _storage.size();
-				if (_lookup.find(v) != _lookup.end()) {
-					// Found it
-					/// @todo double lookups
-					i = _lookup[v];
-				} else {
+				std::pair<typename dictionary_type::iterator, bool> result =
+				    _lookup.insert(std::make_pair(v, count_type(_storage.size())));
+				if (result.second) {
 					// Adding it
-					_storage.push_back(v);
-					_lookup[v] = i;
+					try {
+						_storage.push_back(v);
+					} catch (...) {
+						_lookup.erase(result.first);
+						throw;
+					}
 				}
-				return i;
+				return result.first->second;
+			}
+
+			/** @brief Store every value in [first, last), writing the index of
+				each (in order) to out.
+
+				The numbering is exactly what calling store() on each value in
+				turn would produce. If CUVDictionaryIsOrdered is true for the
+				dictionary policy (as it is for the default), batches of at least
+				BULK_THRESHOLD values are sorted (stably, by value) so that the
+				dictionary is consulted only once per distinct value instead of
+				once per element. That requires operator< equivalence to match
+				the dictionary's notion of equality; other dictionaries, such as
+				hash maps of unordered types, are consulted once per element.
+
+				@returns the output iterator, one past the last index written.
+			*/
+			template<typename ForwardIterator, typename OutputIterator>
+			OutputIterator store_range(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+				return _storeRange(first, last, out, detail::BulkStoreTag<CUVDictionaryIsOrdered<dictionary_policy>::value>());
 			}
 
 			value_type const& get(count_type const& i) const {
@@ -81,6 +175,66 @@ namespace util {
 
 		private:
 			typedef typename dictionary_policy::template apply<value_type, count_type>::type dictionary_type;
+
+			/// store_range() one value at a time
+			template<typename ForwardIterator, typename OutputIterator>
+			OutputIterator _storeRange(ForwardIterator first, ForwardIterator last, OutputIterator out, detail::BulkStoreTag<false>) {
+				for (; first != last; ++first, ++out) {
+					*out = store(*first);
+				}
+				return out;
+			}
+
+			/// store_range() by sorting large batches
+			template<typename ForwardIterator, typename OutputIterator>
+			OutputIterator _storeRange(ForwardIterator first, ForwardIterator last, OutputIterator out, detail::BulkStoreTag<true>) {
+				typedef typename std::iterator_traits<ForwardIterator>::difference_type difference_type;
+				difference_type n = std::distance(first, last);
+				if (n < difference_type(BULK_THRESHOLD)) {
+					return _storeRange(first, last, out, detail::BulkStoreTag<false>());
+				}
+
+				typedef detail::BulkStoreEntry<ForwardIterator> entry_type;
+				std::vector<entry_type> entries;
+				entries.reserve(n);
+				for (std::size_t pos = 0; first != last; ++first, ++pos) {
+					entries.push_back(entry_type(first, pos));
+				}
+				std::sort(entries.begin(), entries.end(), detail::BulkStoreEntryLess<ForwardIterator>());
+
+				// Look up each distinct value (the first entry of each run) just
+				// once, and collect the ones we haven't seen before.
+				std::vector<count_type> indices(entries.size());
+				std::vector<detail::BulkStoreRun> newRuns;
+				for (std::size_t runStart = 0, runEnd = 0; runStart < entries.size(); runStart = runEnd) {
+					value_type const& v = *(entries[runStart].it);
+					for (runEnd = runStart + 1; runEnd < entries.size() && !(v < *(entries[runEnd].it)); ++runEnd) {}
+
+					typename dictionary_type::const_iterator existing = _lookup.find(v);
+					if (existing == _lookup.end()) {
+						newRuns.push_back(detail::BulkStoreRun(entries[runStart].pos, runStart, runEnd));
+					} else {
+						_fillRun(entries, runStart, runEnd, existing->second, indices);
+					}
+				}
+
+				// New values get numbered in order of first appearance, as if
+				// they'd been stored serially.
+				std::sort(newRuns.begin(), newRuns.end());
+				for (std::size_t i = 0; i < newRuns.size(); ++i) {
+					detail::BulkStoreRun const& run = newRuns[i];
+					_fillRun(entries, run.begin, run.end, store(*(entries[run.begin].it)), indices);
+				}
+				return std::copy(indices.begin(), indices.end(), out);
+			}
+
+			template<typename Entries>
+			static void _fillRun(Entries const& entries, std::size_t runStart, std::size_t runEnd, count_type index, std::vector<count_type> & indices) {
+				for (std::size_t e = runStart; e < runEnd; ++e) {
+					indices[entries[e].pos] = index;
+				}
+			}
+
 			storage_type _storage;
 			dictionary_type _lookup;
 	};
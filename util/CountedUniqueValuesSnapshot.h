@@ -0,0 +1,392 @@
+/** @file
+	@brief Header providing a compact binary snapshot format for
+	CountedUniqueValues and CountedUniqueStrings tables, designed to be used
+	directly from read-only memory (such as a memory-mapped file).
+
+	Snapshot layout (all integers little-endian, all sections 8-byte aligned):
+
+	- 64-byte header: magic "UTILCUV", format version, kind (fixed-size
+	  values or strings), value size, value count, hash table size, and the
+	  offsets of the value and hash table sections.
+	- Values section: for fixed-size values, the values themselves,
+	  contiguous in index order. For strings, count + 1 64-bit offsets
+	  followed by the null-terminated string bytes.
+	- Hash table: open-addressed (linear probing) slots of a 64-bit FNV-1a
+	  hash of the value bytes and index + 1 (0 meaning empty).
+
+	All references are offsets, so a reader can call get(i) or find(v) on
+	the mapped bytes with no deserialization step.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_CountedUniqueValuesSnapshot_h_GUID_98f129cd_3249_4426_bf1f_bdda03a20bb4
+#define INCLUDED_CountedUniqueValuesSnapshot_h_GUID_98f129cd_3249_4426_bf1f_bdda03a20bb4
+
+// Internal Includes
+#include <util/CountedUniqueStrings.h>
+#include <util/CountedUniqueValues.h>
+#include <util/booststdint.h>
+
+// Library/third-party includes
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/is_pod.hpp>
+#include <boost/utility/string_ref.hpp>
+
+// Standard includes
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace util {
+
+	namespace detail {
+		enum {
+			CUV_SNAPSHOT_VERSION = 1,
+			CUV_SNAPSHOT_KIND_FIXED = 1,
+			CUV_SNAPSHOT_KIND_STRINGS = 2
+		};
+
+		/// @internal
+		/// @brief The 64-byte header at the start of every snapshot.
+		struct CUVSnapshotHeader {
+			char magic[8];
+			stdint::uint32_t version;
+			stdint::uint32_t kind;
+			stdint::uint64_t valueSize;
+			stdint::uint64_t count;
+			stdint::uint64_t tableSize;
+			stdint::uint64_t valuesOffset;
+			stdint::uint64_t tableOffset;
+			stdint::uint64_t totalSize;
+		};
+
+		/// @internal
+		struct CUVSnapshotSlot {
+			stdint::uint64_t hash;
+			stdint::uint64_t index;
+		};
+
+		inline const char * cuvSnapshotMagic() {
+			return "UTILCUV";
+		}
+
+		inline bool hostIsLittleEndian() {
+			stdint::uint16_t v = 1;
+			return *reinterpret_cast<unsigned char *>(&v) == 1;
+		}
+
+		inline stdint::uint64_t roundUpTo8(stdint::uint64_t n) {
+			return (n + 7) & ~stdint::uint64_t(7);
+		}
+
+		/// @internal
+		/// @brief Accessor used by the snapshot writer for fixed-size values.
+		template<typename Container>
+		struct CUVFixedBytes {
+			explicit CUVFixedBytes(Container const& c) : container(c) {}
+			boost::string_ref operator()(std::size_t i) const {
+				return boost::string_ref(reinterpret_cast<const char *>(&(container[i])), sizeof(container[i]));
+			}
+			Container const& container;
+		};
+
+		/// @internal
+		/// @brief Accessor used by the snapshot writer for string values.
+		template<typename Container>
+		struct CUVStringBytes {
+			explicit CUVStringBytes(Container const& c) : container(c) {}
+			boost::string_ref operator()(std::size_t i) const {
+				return boost::string_ref(container[i]);
+			}
+			Container const& container;
+		};
+
+		/// @internal
+		/// @brief Writes a snapshot of count values, whose bytes are
+		/// provided by getBytes(i).
+		template<typename GetBytes>
+		inline void writeCUVSnapshot(std::ostream & os, std::size_t count, stdint::uint32_t kind, std::size_t valueSize, GetBytes getBytes) {
+			if (!hostIsLittleEndian()) {
+				throw std::runtime_error("CountedUniqueValues snapshots can only be written on little-endian hosts!");
+			}
+			CUVSnapshotHeader header;
+			std::memset(&header, 0, sizeof(header));
+			std::memcpy(header.magic, cuvSnapshotMagic(), sizeof(header.magic));
+			header.version = CUV_SNAPSHOT_VERSION;
+			header.kind = kind;
+			header.valueSize = valueSize;
+			header.count = count;
+			header.tableSize = 16;
+			while (header.tableSize < header.count * 2) {
+				header.tableSize *= 2;
+			}
+			header.valuesOffset = sizeof(header);
+
+			// Build the hash table, and the string offsets if applicable.
+			std::vector<CUVSnapshotSlot> table(header.tableSize);
+			std::vector<stdint::uint64_t> stringOffsets;
+			stdint::uint64_t valueBytes = 0;
+			for (std::size_t i = 0; i < count; ++i) {
+				boost::string_ref bytes = getBytes(i);
+				stdint::uint64_t h = fnv1a(bytes.data(), bytes.size());
+				stdint::uint64_t mask = header.tableSize - 1;
+				stdint::uint64_t j = h & mask;
+				while (table[j].index != 0) {
+					j = (j + 1) & mask;
+				}
+				table[j].hash = h;
+				table[j].index = i + 1;
+
+				if (kind == CUV_SNAPSHOT_KIND_STRINGS) {
+					stringOffsets.push_back(valueBytes);
+					valueBytes += bytes.size() + 1;
+				} else {
+					valueBytes += bytes.size();
+				}
+			}
+			if (kind == CUV_SNAPSHOT_KIND_STRINGS) {
+				stringOffsets.push_back(valueBytes);
+				valueBytes += stringOffsets.size() * sizeof(stdint::uint64_t);
+			}
+			header.tableOffset = header.valuesOffset + roundUpTo8(valueBytes);
+			header.totalSize = header.tableOffset + header.tableSize * sizeof(CUVSnapshotSlot);
+
+			os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			if (kind == CUV_SNAPSHOT_KIND_STRINGS) {
+				os.write(reinterpret_cast<const char *>(&(stringOffsets[0])), stringOffsets.size() * sizeof(stdint::uint64_t));
+			}
+			for (std::size_t i = 0; i < count; ++i) {
+				boost::string_ref bytes = getBytes(i);
+				os.write(bytes.data(), bytes.size());
+				if (kind == CUV_SNAPSHOT_KIND_STRINGS) {
+					os.put('\0');
+				}
+			}
+			static const char padding[8] = {0};
+			os.write(padding, roundUpTo8(valueBytes) - valueBytes);
+			os.write(reinterpret_cast<const char *>(&(table[0])), table.size() * sizeof(CUVSnapshotSlot));
+		}
+
+		/// @internal
+		/// @brief Validates a snapshot's header and provides the hash lookup
+		/// shared by the snapshot views.
+		class CUVSnapshotBase {
+			public:
+				typedef std::size_t count_type;
+
+				count_type size() const {
+					return static_cast<count_type>(_header->count);
+				}
+
+			protected:
+				CUVSnapshotBase(const void * data, std::size_t len, stdint::uint32_t kind, std::size_t valueSize)
+					: _base(static_cast<const char *>(data))
+					, _header(static_cast<CUVSnapshotHeader const *>(data)) {
+					if (!hostIsLittleEndian()) {
+						throw std::runtime_error("CountedUniqueValues snapshots can only be read on little-endian hosts!");
+					}
+					if (reinterpret_cast<std::size_t>(data) % 8 != 0) {
+						throw std::runtime_error("CountedUniqueValues snapshot data must be 8-byte aligned!");
+					}
+					if (len < sizeof(CUVSnapshotHeader) || std::memcmp(_header->magic, cuvSnapshotMagic(), sizeof(_header->magic)) != 0) {
+						throw std::runtime_error("Not a CountedUniqueValues snapshot!");
+					}
+					if (_header->version != CUV_SNAPSHOT_VERSION || _header->kind != kind || _header->valueSize != valueSize) {
+						throw std::runtime_error("CountedUniqueValues snapshot has the wrong version or value type!");
+					}
+					if (_header->totalSize > len
+					        || _header->tableSize == 0 || (_header->tableSize & (_header->tableSize - 1)) != 0
+					        || _header->tableSize / 2 < _header->count
+					        || _header->tableOffset > _header->totalSize
+					        || _header->tableSize > (_header->totalSize - _header->tableOffset) / sizeof(CUVSnapshotSlot)
+					        || _header->valuesOffset > _header->tableOffset
+					        || (valueSize
+					            ? _header->count > (_header->tableOffset - _header->valuesOffset) / valueSize
+					            // Strings start with count + 1 offsets of 8 bytes each.
+					            : _header->count >= (_header->tableOffset - _header->valuesOffset) / sizeof(stdint::uint64_t))) {
+						throw std::runtime_error("CountedUniqueValues snapshot is truncated or corrupt!");
+					}
+					_slots = reinterpret_cast<CUVSnapshotSlot const *>(_base + _header->tableOffset);
+				}
+
+				const char * _values() const {
+					return _base + _header->valuesOffset;
+				}
+
+				void _checkIndex(count_type i) const {
+					if (i >= size()) {
+						throw std::out_of_range("Index out of range for CountedUniqueValues snapshot!");
+					}
+				}
+
+				/// Probes the hash table: equal(i) must report whether value i
+				/// is the one being looked for.
+				template<typename Equal>
+				bool _find(boost::string_ref bytes, Equal const& equal, count_type & index) const {
+					stdint::uint64_t h = fnv1a(bytes.data(), bytes.size());
+					stdint::uint64_t mask = _header->tableSize - 1;
+					for (stdint::uint64_t j = h & mask; _slots[j].index != 0; j = (j + 1) & mask) {
+						if (_slots[j].hash == h && equal(static_cast<count_type>(_slots[j].index - 1), bytes)) {
+							index = static_cast<count_type>(_slots[j].index - 1);
+							return true;
+						}
+					}
+					return false;
+				}
+
+			private:
+				const char * _base;
+				CUVSnapshotHeader const * _header;
+				CUVSnapshotSlot const * _slots;
+		};
+	} // end of namespace detail
+
+/// @addtogroup DataStructures Data Structures
+/// @{
+
+	/// @brief Write a snapshot of a table of plain-old-data values.
+	///
+	/// Values are hashed and compared bytewise, so T must not contain padding.
+	template<typename T, typename dictionary_policy>
+	inline void writeSnapshot(std::ostream & os, CountedUniqueValues<T, dictionary_policy> const& values) {
+		BOOST_STATIC_ASSERT(boost::is_pod<T>::value);
+		detail::writeCUVSnapshot(os, values.size(), detail::CUV_SNAPSHOT_KIND_FIXED, sizeof(T),
+		                         detail::CUVFixedBytes<CountedUniqueValues<T, dictionary_policy> >(values));
+	}
+
+	/// @brief Write a snapshot of a table of strings.
+	template<typename dictionary_policy>
+	inline void writeSnapshot(std::ostream & os, CountedUniqueValues<std::string, dictionary_policy> const& values) {
+		detail::writeCUVSnapshot(os, values.size(), detail::CUV_SNAPSHOT_KIND_STRINGS, 0,
+		                         detail::CUVStringBytes<CountedUniqueValues<std::string, dictionary_policy> >(values));
+	}
+
+	/// @brief Write a snapshot of a table of strings.
+	inline void writeSnapshot(std::ostream & os, CountedUniqueStrings const& values) {
+		detail::writeCUVSnapshot(os, values.size(), detail::CUV_SNAPSHOT_KIND_STRINGS, 0,
+		                         detail::CUVStringBytes<CountedUniqueStrings>(values));
+	}
+
+	/** @brief Read-only view of a snapshot written by writeSnapshot(), for
+		plain-old-data values.
+
+		Does not copy or take ownership of the data, which must stay valid
+		(and 8-byte aligned) for the lifetime of the view. Only the header is
+		validated on construction: the rest of the snapshot is trusted.
+	*/
+	template<typename T>
+	class CountedUniqueValuesSnapshot : public detail::CUVSnapshotBase {
+			BOOST_STATIC_ASSERT(boost::is_pod<T>::value);
+			BOOST_STATIC_ASSERT(boost::alignment_of<T>::value <= 8);
+		public:
+			typedef T value_type;
+
+			/// @throws std::runtime_error if data does not hold a valid
+			/// snapshot of this value type.
+			CountedUniqueValuesSnapshot(const void * data, std::size_t len)
+				: detail::CUVSnapshotBase(data, len, detail::CUV_SNAPSHOT_KIND_FIXED, sizeof(T)) {
+			}
+
+			value_type const& get(count_type const& i) const {
+				_checkIndex(i);
+				return (*this)[i];
+			}
+
+			value_type const& operator[](count_type const& i) const {
+				return reinterpret_cast<value_type const *>(_values())[i];
+			}
+
+			/// @brief Reverse lookup: find the index of v, if present.
+			bool find(value_type const& v, count_type & index) const {
+				return _find(boost::string_ref(reinterpret_cast<const char *>(&v), sizeof(v)), BytesEqual(*this), index);
+			}
+
+		private:
+			struct BytesEqual {
+				explicit BytesEqual(CountedUniqueValuesSnapshot const& s) : snapshot(s) {}
+				bool operator()(count_type i, boost::string_ref bytes) const {
+					return std::memcmp(&(snapshot[i]), bytes.data(), bytes.size()) == 0;
+				}
+				CountedUniqueValuesSnapshot const& snapshot;
+			};
+	};
+
+	/** @brief Read-only view of a snapshot written by writeSnapshot(), for
+		strings (from either CountedUniqueValues<std::string> or
+		CountedUniqueStrings).
+
+		Does not copy or take ownership of the data, which must stay valid
+		(and 8-byte aligned) for the lifetime of the view. Only the header is
+		validated on construction: the rest of the snapshot is trusted.
+	*/
+	template<>
+	class CountedUniqueValuesSnapshot<std::string> : public detail::CUVSnapshotBase {
+		public:
+			typedef boost::string_ref value_type;
+
+			/// @throws std::runtime_error if data does not hold a valid
+			/// snapshot of strings.
+			CountedUniqueValuesSnapshot(const void * data, std::size_t len)
+				: detail::CUVSnapshotBase(data, len, detail::CUV_SNAPSHOT_KIND_STRINGS, 0) {
+			}
+
+			value_type get(count_type const& i) const {
+				_checkIndex(i);
+				return (*this)[i];
+			}
+
+			value_type operator[](count_type const& i) const {
+				return value_type(c_str(i), static_cast<std::size_t>(_offsets()[i + 1] - _offsets()[i] - 1));
+			}
+
+			/// @brief Null-terminated access to a stored string
+			const char * c_str(count_type const& i) const {
+				return _strings() + _offsets()[i];
+			}
+
+			/// @brief Reverse lookup: find the index of v, if present.
+			bool find(value_type const& v, count_type & index) const {
+				return _find(v, StringEqual(*this), index);
+			}
+
+		private:
+			stdint::uint64_t const * _offsets() const {
+				return reinterpret_cast<stdint::uint64_t const *>(_values());
+			}
+
+			const char * _strings() const {
+				return _values() + (size() + 1) * sizeof(stdint::uint64_t);
+			}
+
+			struct StringEqual {
+				explicit StringEqual(CountedUniqueValuesSnapshot const& s) : snapshot(s) {}
+				bool operator()(count_type i, boost::string_ref bytes) const {
+					return snapshot[i] == bytes;
+				}
+				CountedUniqueValuesSnapshot const& snapshot;
+			};
+	};
+
+/// @}
+
+} // end of namespace util
+
+#endif // INCLUDED_CountedUniqueValuesSnapshot_h_GUID_98f129cd_3249_4426_bf1f_bdda03a20bb4
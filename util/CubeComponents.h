@@ -31,9 +31,73 @@
 // Standard includes
 #include <bitset>
 #include <cassert>
+#include <cstddef>
 #include <stdexcept>
 #include <iosfwd>
 
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define UTIL_CUBECOMPONENTS_HAVE_CONSTEXPR
+#endif
+
+// Contents of the cube topology tables, shared by the constexpr and the
+// C++98 definitions of util::CubeComponents::detail::CubeTopologyTables
+#define UTIL_CUBE_VERTEX_COORDS { \
+	{ -1, -1, -1}, {1, -1, -1}, { -1, 1, -1}, {1, 1, -1}, \
+	{ -1, -1, 1}, {1, -1, 1}, { -1, 1, 1}, {1, 1, 1} \
+}
+#define UTIL_CUBE_VERTEX_NEIGHBORS { \
+	{1, 2, 4}, {0, 3, 5}, {3, 0, 6}, {2, 1, 7}, {5, 6, 0}, {4, 7, 1}, {7, 4, 2}, {6, 5, 3} \
+}
+#define UTIL_CUBE_VERTEX_EDGES { \
+	{0, 4, 8}, {0, 5, 9}, {1, 4, 10}, {1, 5, 11}, {2, 6, 8}, {2, 7, 9}, {3, 6, 10}, {3, 7, 11} \
+}
+#define UTIL_CUBE_VERTEX_FACE_MASK { \
+	0x07, 0x0e, 0x15, 0x1c, 0x23, 0x2a, 0x31, 0x38 \
+}
+#define UTIL_CUBE_FACE_VERTICES { \
+	{0, 2, 4, 6}, {0, 1, 4, 5}, {0, 1, 2, 3}, {1, 3, 5, 7}, {2, 3, 6, 7}, {4, 5, 6, 7} \
+}
+#define UTIL_CUBE_FACE_CENTERS { \
+	{ -1, 0, 0}, {0, -1, 0}, {0, 0, -1}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1} \
+}
+#define UTIL_CUBE_EDGE_VERTICES { \
+	{0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7} \
+}
+#define UTIL_CUBE_CASE_EDGE_MASK { \
+	0x000, 0x111, 0x221, 0x330, 0x412, 0x503, 0x633, 0x722, \
+	0x822, 0x933, 0xa03, 0xb12, 0xc30, 0xd21, 0xe11, 0xf00, \
+	0x144, 0x055, 0x365, 0x274, 0x556, 0x447, 0x777, 0x666, \
+	0x966, 0x877, 0xb47, 0xa56, 0xd74, 0xc65, 0xf55, 0xe44, \
+	0x284, 0x395, 0x0a5, 0x1b4, 0x696, 0x787, 0x4b7, 0x5a6, \
+	0xaa6, 0xbb7, 0x887, 0x996, 0xeb4, 0xfa5, 0xc95, 0xd84, \
+	0x3c0, 0x2d1, 0x1e1, 0x0f0, 0x7d2, 0x6c3, 0x5f3, 0x4e2, \
+	0xbe2, 0xaf3, 0x9c3, 0x8d2, 0xff0, 0xee1, 0xdd1, 0xcc0, \
+	0x448, 0x559, 0x669, 0x778, 0x05a, 0x14b, 0x27b, 0x36a, \
+	0xc6a, 0xd7b, 0xe4b, 0xf5a, 0x878, 0x969, 0xa59, 0xb48, \
+	0x50c, 0x41d, 0x72d, 0x63c, 0x11e, 0x00f, 0x33f, 0x22e, \
+	0xd2e, 0xc3f, 0xf0f, 0xe1e, 0x93c, 0x82d, 0xb1d, 0xa0c, \
+	0x6cc, 0x7dd, 0x4ed, 0x5fc, 0x2de, 0x3cf, 0x0ff, 0x1ee, \
+	0xeee, 0xfff, 0xccf, 0xdde, 0xafc, 0xbed, 0x8dd, 0x9cc, \
+	0x788, 0x699, 0x5a9, 0x4b8, 0x39a, 0x28b, 0x1bb, 0x0aa, \
+	0xfaa, 0xebb, 0xd8b, 0xc9a, 0xbb8, 0xaa9, 0x999, 0x888, \
+	0x888, 0x999, 0xaa9, 0xbb8, 0xc9a, 0xd8b, 0xebb, 0xfaa, \
+	0x0aa, 0x1bb, 0x28b, 0x39a, 0x4b8, 0x5a9, 0x699, 0x788, \
+	0x9cc, 0x8dd, 0xbed, 0xafc, 0xdde, 0xccf, 0xfff, 0xeee, \
+	0x1ee, 0x0ff, 0x3cf, 0x2de, 0x5fc, 0x4ed, 0x7dd, 0x6cc, \
+	0xa0c, 0xb1d, 0x82d, 0x93c, 0xe1e, 0xf0f, 0xc3f, 0xd2e, \
+	0x22e, 0x33f, 0x00f, 0x11e, 0x63c, 0x72d, 0x41d, 0x50c, \
+	0xb48, 0xa59, 0x969, 0x878, 0xf5a, 0xe4b, 0xd7b, 0xc6a, \
+	0x36a, 0x27b, 0x14b, 0x05a, 0x778, 0x669, 0x559, 0x448, \
+	0xcc0, 0xdd1, 0xee1, 0xff0, 0x8d2, 0x9c3, 0xaf3, 0xbe2, \
+	0x4e2, 0x5f3, 0x6c3, 0x7d2, 0x0f0, 0x1e1, 0x2d1, 0x3c0, \
+	0xd84, 0xc95, 0xfa5, 0xeb4, 0x996, 0x887, 0xbb7, 0xaa6, \
+	0x5a6, 0x4b7, 0x787, 0x696, 0x1b4, 0x0a5, 0x395, 0x284, \
+	0xe44, 0xf55, 0xc65, 0xd74, 0xa56, 0xb47, 0x877, 0x966, \
+	0x666, 0x777, 0x447, 0x556, 0x274, 0x365, 0x055, 0x144, \
+	0xf00, 0xe11, 0xd21, 0xc30, 0xb12, 0xa03, 0x933, 0x822, \
+	0x722, 0x633, 0x503, 0x412, 0x330, 0x221, 0x111, 0x000 \
+}
+
 namespace util {
 
 	namespace {
@@ -81,8 +145,221 @@ namespace util {
 						throw std::out_of_range("Location to insert bit is out of range!");
 				}
 			}
+
+			/// @internal
+			/// @brief Precomputed cube topology, following the ID conventions
+			/// of Cube: vertex bit i is coordinate i (x, y, z), face j fixes bit
+			/// j % 3 to the value j / 3, and edge e runs along axis e / 4.
+			///
+			/// A class template only so the static tables may be defined in
+			/// this header. The tables are constexpr where supported, so they
+			/// may be used in constant expressions; otherwise they are const.
+			template<typename Dummy = void>
+			struct CubeTopologyTables {
+#ifdef UTIL_CUBECOMPONENTS_HAVE_CONSTEXPR
+				/// Coordinates (+-1) of each vertex of a 2x2x2 cube centered
+				/// on the origin.
+				static constexpr signed char vertexCoords[8][3] = UTIL_CUBE_VERTEX_COORDS;
+				/// Vertex neighbor m differs from the vertex in bit m.
+				static constexpr unsigned char vertexNeighbors[8][3] = UTIL_CUBE_VERTEX_NEIGHBORS;
+				/// The edge leaving each vertex along each axis.
+				static constexpr unsigned char vertexEdges[8][3] = UTIL_CUBE_VERTEX_EDGES;
+				/// Bitmask of the faces each vertex belongs to.
+				static constexpr unsigned char vertexFaceMask[8] = UTIL_CUBE_VERTEX_FACE_MASK;
+				/// Cube vertex IDs of face vertices 0, 1, 2, 3 of each face.
+				static constexpr unsigned char faceVertices[6][4] = UTIL_CUBE_FACE_VERTICES;
+				/// Coordinates of the center of each face.
+				static constexpr signed char faceCenters[6][3] = UTIL_CUBE_FACE_CENTERS;
+				/// Vertex IDs of the two ends of each edge (lower, then upper).
+				static constexpr unsigned char edgeVertices[12][2] = UTIL_CUBE_EDGE_VERTICES;
+				/// For a marching-cubes case (bit v set if vertex v is
+				/// inside), the bitmask of edges that cross the surface.
+				static constexpr unsigned short caseEdgeMask[256] = UTIL_CUBE_CASE_EDGE_MASK;
+#else
+				/// Coordinates (+-1) of each vertex of a 2x2x2 cube centered
+				/// on the origin.
+				static const signed char vertexCoords[8][3];
+				/// Vertex neighbor m differs from the vertex in bit m.
+				static const unsigned char vertexNeighbors[8][3];
+				/// The edge leaving each vertex along each axis.
+				static const unsigned char vertexEdges[8][3];
+				/// Bitmask of the faces each vertex belongs to.
+				static const unsigned char vertexFaceMask[8];
+				/// Cube vertex IDs of face vertices 0, 1, 2, 3 of each face.
+				static const unsigned char faceVertices[6][4];
+				/// Coordinates of the center of each face.
+				static const signed char faceCenters[6][3];
+				/// Vertex IDs of the two ends of each edge (lower, then upper).
+				static const unsigned char edgeVertices[12][2];
+				/// For a marching-cubes case (bit v set if vertex v is
+				/// inside), the bitmask of edges that cross the surface.
+				static const unsigned short caseEdgeMask[256];
+#endif
+			};
+
+#ifdef UTIL_CUBECOMPONENTS_HAVE_CONSTEXPR
+			template<typename Dummy>
+			constexpr signed char CubeTopologyTables<Dummy>::vertexCoords[8][3];
+			template<typename Dummy>
+			constexpr unsigned char CubeTopologyTables<Dummy>::vertexNeighbors[8][3];
+			template<typename Dummy>
+			constexpr unsigned char CubeTopologyTables<Dummy>::vertexEdges[8][3];
+			template<typename Dummy>
+			constexpr unsigned char CubeTopologyTables<Dummy>::vertexFaceMask[8];
+			template<typename Dummy>
+			constexpr unsigned char CubeTopologyTables<Dummy>::faceVertices[6][4];
+			template<typename Dummy>
+			constexpr signed char CubeTopologyTables<Dummy>::faceCenters[6][3];
+			template<typename Dummy>
+			constexpr unsigned char CubeTopologyTables<Dummy>::edgeVertices[12][2];
+			template<typename Dummy>
+			constexpr unsigned short CubeTopologyTables<Dummy>::caseEdgeMask[256];
+#else
+			template<typename Dummy>
+			const signed char CubeTopologyTables<Dummy>::vertexCoords[8][3] = UTIL_CUBE_VERTEX_COORDS;
+			template<typename Dummy>
+			const unsigned char CubeTopologyTables<Dummy>::vertexNeighbors[8][3] = UTIL_CUBE_VERTEX_NEIGHBORS;
+			template<typename Dummy>
+			const unsigned char CubeTopologyTables<Dummy>::vertexEdges[8][3] = UTIL_CUBE_VERTEX_EDGES;
+			template<typename Dummy>
+			const unsigned char CubeTopologyTables<Dummy>::vertexFaceMask[8] = UTIL_CUBE_VERTEX_FACE_MASK;
+			template<typename Dummy>
+			const unsigned char CubeTopologyTables<Dummy>::faceVertices[6][4] = UTIL_CUBE_FACE_VERTICES;
+			template<typename Dummy>
+			const signed char CubeTopologyTables<Dummy>::faceCenters[6][3] = UTIL_CUBE_FACE_CENTERS;
+			template<typename Dummy>
+			const unsigned char CubeTopologyTables<Dummy>::edgeVertices[12][2] = UTIL_CUBE_EDGE_VERTICES;
+			template<typename Dummy>
+			const unsigned short CubeTopologyTables<Dummy>::caseEdgeMask[256] = UTIL_CUBE_CASE_EDGE_MASK;
+#endif
+
+#undef UTIL_CUBE_VERTEX_COORDS
+#undef UTIL_CUBE_VERTEX_NEIGHBORS
+#undef UTIL_CUBE_VERTEX_EDGES
+#undef UTIL_CUBE_VERTEX_FACE_MASK
+#undef UTIL_CUBE_FACE_VERTICES
+#undef UTIL_CUBE_FACE_CENTERS
+#undef UTIL_CUBE_EDGE_VERTICES
+#undef UTIL_CUBE_CASE_EDGE_MASK
+
+			typedef CubeTopologyTables<> Topology;
 		} // end of namespace detail
 
+		/// @name Unchecked topology queries
+		/// Table lookups on raw IDs, for inner loops: arguments are only
+		/// checked by assertions.
+		/// @{
+
+		/// Vertex coordinate (+-1) along axis in 0, 1, 2
+		inline signed char vertexCoordinate(unsigned char vertex, unsigned char axis) {
+			assert(vertex < 8 && axis < 3);
+			return detail::Topology::vertexCoords[vertex][axis];
+		}
+
+		/// Vertex neighbor m, where m is in 0, 1, 2
+		inline unsigned char vertexNeighbor(unsigned char vertex, unsigned char m) {
+			assert(vertex < 8 && m < 3);
+			return detail::Topology::vertexNeighbors[vertex][m];
+		}
+
+		/// Edge from a vertex along axis in 0, 1, 2
+		inline unsigned char vertexEdge(unsigned char vertex, unsigned char axis) {
+			assert(vertex < 8 && axis < 3);
+			return detail::Topology::vertexEdges[vertex][axis];
+		}
+
+		/// Bitmask of the faces containing a vertex
+		inline unsigned char vertexFaceMask(unsigned char vertex) {
+			assert(vertex < 8);
+			return detail::Topology::vertexFaceMask[vertex];
+		}
+
+		/// Cube vertex ID of face vertex k (in 0, 1, 2, 3) of a face
+		inline unsigned char faceVertex(unsigned char face, unsigned char k) {
+			assert(face < 6 && k < 4);
+			return detail::Topology::faceVertices[face][k];
+		}
+
+		/// Vertex ID of end (0 or 1) of an edge in 0, 1, ..., 11
+		inline unsigned char edgeVertex(unsigned char edge, unsigned char end) {
+			assert(edge < 12 && end < 2);
+			return detail::Topology::edgeVertices[edge][end];
+		}
+
+		/// Bitmask of edges crossing the surface for a marching-cubes case
+		inline unsigned short caseEdgeMask(unsigned char caseIndex) {
+			return detail::Topology::caseEdgeMask[caseIndex];
+		}
+
+		/// @}
+
+		/// @name Batch geometry
+		/// Positions for many cubes at once, in structure-of-arrays form:
+		/// cube i is centered at (originX[i], originY[i], originZ[i]) with
+		/// half-edge-length scale[i], so its vertex v is at origin + scale *
+		/// Cube::Vertex(v).get(). Outputs are corner-major: the value for
+		/// corner (or face) c of cube i is at index c * n + i, so each corner
+		/// is computed as one array expression with Eigen's packet math.
+		/// Works with Scalar float or double.
+		/// @{
+
+		/// Write the 8 vertex positions of each of n cubes to outX, outY and
+		/// outZ, each of which must have room for 8 * n values.
+		template<typename Scalar>
+		inline void batchVertexPositions(Scalar const * originX, Scalar const * originY, Scalar const * originZ,
+		                                 Scalar const * scale, std::size_t n,
+		                                 Scalar * outX, Scalar * outY, Scalar * outZ) {
+			typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> ArrayType;
+			typedef Eigen::Map<const ArrayType> ConstMap;
+			typedef Eigen::Map<ArrayType> OutMap;
+			const Eigen::DenseIndex size = static_cast<Eigen::DenseIndex>(n);
+			ConstMap origin[3] = {ConstMap(originX, size), ConstMap(originY, size), ConstMap(originZ, size)};
+			ConstMap s(scale, size);
+			Scalar * out[3] = {outX, outY, outZ};
+			for (unsigned char v = 0; v < 8; ++v) {
+				for (unsigned char axis = 0; axis < 3; ++axis) {
+					OutMap dest(out[axis] + v * n, size);
+					if (detail::Topology::vertexCoords[v][axis] > 0) {
+						dest = origin[axis] + s;
+					} else {
+						dest = origin[axis] - s;
+					}
+				}
+			}
+		}
+
+		/// Write the 6 face centers of each of n cubes to outX, outY and
+		/// outZ, each of which must have room for 6 * n values.
+		template<typename Scalar>
+		inline void batchFaceCenters(Scalar const * originX, Scalar const * originY, Scalar const * originZ,
+		                             Scalar const * scale, std::size_t n,
+		                             Scalar * outX, Scalar * outY, Scalar * outZ) {
+			typedef Eigen::Array<Scalar, Eigen::Dynamic, 1> ArrayType;
+			typedef Eigen::Map<const ArrayType> ConstMap;
+			typedef Eigen::Map<ArrayType> OutMap;
+			const Eigen::DenseIndex size = static_cast<Eigen::DenseIndex>(n);
+			ConstMap origin[3] = {ConstMap(originX, size), ConstMap(originY, size), ConstMap(originZ, size)};
+			ConstMap s(scale, size);
+			Scalar * out[3] = {outX, outY, outZ};
+			for (unsigned char f = 0; f < 6; ++f) {
+				for (unsigned char axis = 0; axis < 3; ++axis) {
+					OutMap dest(out[axis] + f * n, size);
+					switch (detail::Topology::faceCenters[f][axis]) {
+						case 1:
+							dest = origin[axis] + s;
+							break;
+						case -1:
+							dest = origin[axis] - s;
+							break;
+						default:
+							dest = origin[axis];
+					}
+				}
+			}
+		}
+
+		/// @}
+
 		template<typename _VecType = Eigen::Vector3d>
 		struct Cube {
 				typedef unsigned char BitIDType;
@@ -94,12 +371,17 @@ namespace util {
 				class Face;
 				class FaceVertex;
 
+				/// Tag selecting constructors that skip range checks
+				struct Unchecked {};
+
 				/** @brief Representation of a vertex of a 2x2x2 cube centered at the origin
 
 					A set of 3 bits is used to represent a vertex, where each bit
 					corresponds to a dimension (in {x, y, z}), and values are mapped
 					0 -> -1 and 1 -> 1. A vertex's neighbors vary in one bit from the
 					its own value.
+
+					Only the ID is stored: queries are lookups in precomputed tables.
 				*/
 				class Vertex : public detail::Outputable {
 					public:
@@ -108,51 +390,59 @@ namespace util {
 						static const IDType COUNT = 8;
 
 						/// Default constructor: constructs vertex 0
-						Vertex() {}
+						Vertex() : _id(0) {}
 
 						/// Constructor from a bitset
 						explicit Vertex(BitsetType const& val)
-							: _v(val) {
+							: _id(static_cast<IDType>(val.to_ulong())) {
 						}
 
 						/// Constructor from a vertex ID in range 0, 1, ..., 7
 						explicit Vertex(IDType val)
-							: _v(val) {
+							: _id(val) {
 							if (val >= COUNT) {
 								throw std::out_of_range("Vertex index specified is out of range  {0, 1, ..., 7} !");
 							}
 						}
 
+						/// Constructor from a vertex ID in range 0, 1, ..., 7,
+						/// only checked by assertion.
+						Vertex(IDType val, Unchecked)
+							: _id(val) {
+							assert(val < COUNT);
+						}
+
 						/// Get the coordinates of this vertex in a 2x2x2 cube centered
 						/// on the origin. (All components will be +-1)
 						VectorType get() const {
-							return VectorType(_v[0], _v[1], _v[2]) * 2 - VectorType::Constant(1);
+							return VectorType(detail::Topology::vertexCoords[_id][0],
+							                  detail::Topology::vertexCoords[_id][1],
+							                  detail::Topology::vertexCoords[_id][2]);
 						}
 
 						/// Get vertex ID in range 0, 1, ..., 7
 						IDType getID() const {
-							return _v.to_ulong();
+							return _id;
 						}
 
 						/// Get bitset corresponding to this vertex
-						BitsetType const& getBitset() const {
-							return _v;
+						BitsetType getBitset() const {
+							return BitsetType(_id);
 						}
 
 						/// Get vertex neighbor m, where m is in 0, 1, 2
-						Vertex getNeighbor(IDType m) {
-							assert(m < 3);
-							return Vertex(BitsetType(_v).flip(m));
+						Vertex getNeighbor(IDType m) const {
+							return Vertex(vertexNeighbor(_id, m), Unchecked());
 						}
 
 						/// Compare vertex equality based on ID
 						bool operator==(Vertex const& other) const {
-							return _v == other._v;
+							return _id == other._id;
 						}
 
 						/// Compare vertex inequality based on ID
 						bool operator!=(Vertex const& other) const {
-							return _v != other._v;
+							return _id != other._id;
 						}
 
 
@@ -161,7 +451,7 @@ namespace util {
 							os << "Vertex " << getID();
 						}
 
-						BitsetType _v;
+						IDType _id;
 				};
 
 				/** @brief Representation of a face of a 2x2x2 cube centered at the origin.
@@ -198,9 +488,10 @@ namespace util {
 
 						/// Get coordinates of the center of this face
 						VectorType getCenter() const {
-							return VectorType(_fixedBit == 0 ? _bitval * 2 - 1 : 0,
-							                  _fixedBit == 1 ? _bitval * 2 - 1 : 0,
-							                  _fixedBit == 2 ? _bitval * 2 - 1 : 0);
+							IDType id = getID();
+							return VectorType(detail::Topology::faceCenters[id][0],
+							                  detail::Topology::faceCenters[id][1],
+							                  detail::Topology::faceCenters[id][2]);
 						}
 
 						/// Get outward-pointing normal of this face
@@ -224,10 +515,16 @@ namespace util {
 						}
 
 						/// Get one of the vertices of this face, with id in 0, 1, 2, 3
-						FaceVertex getFaceVertex(IDType k) {
+						FaceVertex getFaceVertex(IDType k) const {
 							return FaceVertex(*this, k);
 						}
 
+						/// Get the cube vertex that is face vertex k of this face,
+						/// with k in 0, 1, 2, 3 (only checked by assertion)
+						Vertex getCubeVertex(IDType k) const {
+							return Vertex(faceVertex(getID(), k), Unchecked());
+						}
+
 						/// Comparison operator based on face ID
 						bool operator==(Face const& other) const {
 							return getID() == other.getID();
@@ -280,12 +577,12 @@ namespace util {
 							if (n >= 2) {
 								throw std::out_of_range("Face vertex neighbor index specified is out of range {0, 1} !");
 							}
-							return FaceVertex(getFace(), BitsetType(_vertexID).flip(n).to_ulong());
+							return FaceVertex(getFace(), _vertexID ^ (1 << n));
 						}
 
 						/// Conversion operator to (Cube) Vertex
 						operator Vertex() const {
-							return Vertex(detail::bitsetInsert(BitsetType(_vertexID), _bitval, _fixedBit));
+							return Vertex(faceVertex(_bitval * 3 + _fixedBit, _vertexID), Unchecked());
 						}
 
 						/// Explicit method for converting to cube Vertex
@@ -0,0 +1,341 @@
+/** @file
+	@brief Header providing a compact binary block format for Eigen
+	matrices, arrays and quaternions, readable in place (for instance from a
+	memory-mapped file) through Eigen::Map.
+
+	Each block is a 32-byte header followed by the coefficients of one or
+	more objects of the same type and size, in their own storage order,
+	padded to a multiple of 8 bytes. All values are little-endian.
+
+	For compatibility with boost::serialization archives, see
+	EigenMatrixSerialize.h instead.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_EigenBinarySerialize_h_GUID_07c1bc6f_db8c_4719_a7b2_562ab09b0a27
+#define INCLUDED_EigenBinarySerialize_h_GUID_07c1bc6f_db8c_4719_a7b2_562ab09b0a27
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+
+	/// @brief Header preceding each block of an Eigen binary stream.
+	struct EigenBinaryBlockHeader {
+		enum Kind {
+			KIND_MATRIX = 1,
+			KIND_ARRAY = 2,
+			KIND_QUATERNION = 3
+		};
+		enum Flags {
+			FLAG_ROW_MAJOR = 1
+		};
+
+		/// "EIGB"
+		char magic[4];
+		std::uint8_t scalarType;
+		std::uint8_t kind;
+		std::uint8_t flags;
+		std::uint8_t reserved;
+		/// Number of objects in the block
+		std::uint64_t count;
+		std::uint64_t rows;
+		std::uint64_t cols;
+	};
+
+	namespace detail {
+		/// @internal
+		/// @brief Identifies the supported scalar types in block headers.
+		template<typename Scalar>
+		struct EigenBinaryScalarType;
+
+		template<>
+		struct EigenBinaryScalarType<float> : std::integral_constant<std::uint8_t, 1> {};
+		template<>
+		struct EigenBinaryScalarType<double> : std::integral_constant<std::uint8_t, 2> {};
+		template<>
+		struct EigenBinaryScalarType<std::int32_t> : std::integral_constant<std::uint8_t, 3> {};
+		template<>
+		struct EigenBinaryScalarType<std::int64_t> : std::integral_constant<std::uint8_t, 4> {};
+
+		inline bool eigenBinaryHostIsLittleEndian() {
+			const std::uint16_t v = 1;
+			return *reinterpret_cast<const unsigned char *>(&v) == 1;
+		}
+
+		inline void eigenBinaryRequireLittleEndian() {
+			if (!eigenBinaryHostIsLittleEndian()) {
+				throw std::runtime_error("The Eigen binary format is only supported on little-endian hosts!");
+			}
+		}
+
+		inline std::uint64_t eigenBinaryPadding(std::uint64_t bytes) {
+			return (8 - (bytes & 7)) & 7;
+		}
+
+		/// @internal
+		/// @brief Describes how type T is stored in a block.
+		template<typename T>
+		struct EigenBinaryTraits {
+			typedef typename T::Scalar ScalarType;
+			static const std::uint8_t kind = std::is_base_of<Eigen::ArrayBase<T>, T>::value
+			                                 ? EigenBinaryBlockHeader::KIND_ARRAY
+			                                 : EigenBinaryBlockHeader::KIND_MATRIX;
+			static const std::uint8_t flags = T::IsRowMajor ? EigenBinaryBlockHeader::FLAG_ROW_MAJOR : 0;
+			static const int rowsAtCompileTime = T::RowsAtCompileTime;
+			static const int colsAtCompileTime = T::ColsAtCompileTime;
+		};
+
+		template<typename Scalar, int Options>
+		struct EigenBinaryTraits<Eigen::Quaternion<Scalar, Options> > {
+			typedef Scalar ScalarType;
+			static const std::uint8_t kind = EigenBinaryBlockHeader::KIND_QUATERNION;
+			static const std::uint8_t flags = 0;
+			static const int rowsAtCompileTime = 4;
+			static const int colsAtCompileTime = 1;
+		};
+
+		inline bool eigenBinaryDimensionMatches(int atCompileTime, std::uint64_t actual) {
+			return atCompileTime == Eigen::Dynamic || std::uint64_t(atCompileTime) == actual;
+		}
+	} // end of namespace detail
+
+/// @addtogroup Math Math Utilities
+/// @{
+
+	/** @brief Writes Eigen objects as binary blocks to a stream.
+
+		Supports float, double, std::int32_t and std::int64_t matrices and
+		arrays (fixed or dynamic size, either storage order) and quaternions.
+	*/
+	class EigenBinaryWriter {
+		public:
+			/// @throws std::runtime_error on big-endian hosts.
+			explicit EigenBinaryWriter(std::ostream & os) : _os(os) {
+				detail::eigenBinaryRequireLittleEndian();
+			}
+
+			/// @brief Write a plain matrix or array directly from its storage.
+			template<typename Derived>
+			void write(Eigen::PlainObjectBase<Derived> const& m) {
+				_writeBlock<Derived>(1, m.rows(), m.cols(), m.data());
+			}
+
+			/// @brief Write any other expression (block, product, ...) by
+			/// evaluating it first.
+			template<typename Derived>
+			void write(Eigen::DenseBase<Derived> const& expr) {
+				typename Derived::PlainObject m(expr);
+				write(m);
+			}
+
+			template<typename Scalar, int Options>
+			void write(Eigen::Quaternion<Scalar, Options> const& q) {
+				_writeBlock<Eigen::Quaternion<Scalar, Options> >(1, 4, 1, q.coeffs().data());
+			}
+
+			/// @brief Write a whole vector of fixed-size matrices, arrays or
+			/// quaternions as one block, with a single write of their
+			/// contiguous storage.
+			template<typename T, typename Allocator>
+			void write(std::vector<T, Allocator> const& v) {
+				typedef typename detail::EigenBinaryTraits<T>::ScalarType Scalar;
+				static_assert(detail::EigenBinaryTraits<T>::rowsAtCompileTime != Eigen::Dynamic
+				              && detail::EigenBinaryTraits<T>::colsAtCompileTime != Eigen::Dynamic,
+				              "Only vectors of fixed-size objects can be written as one block: write dynamic-size objects one at a time.");
+				static_assert(sizeof(T) == sizeof(Scalar) * detail::EigenBinaryTraits<T>::rowsAtCompileTime
+				              * detail::EigenBinaryTraits<T>::colsAtCompileTime,
+				              "Objects must be stored contiguously, with no padding.");
+				_writeBlock<T>(v.size(), detail::EigenBinaryTraits<T>::rowsAtCompileTime,
+				               detail::EigenBinaryTraits<T>::colsAtCompileTime,
+				               v.empty() ? NULL : reinterpret_cast<Scalar const *>(&(v[0])));
+			}
+
+		private:
+			template<typename T, typename Scalar>
+			void _writeBlock(std::size_t count, std::size_t rows, std::size_t cols, Scalar const * data) {
+				typedef detail::EigenBinaryTraits<T> Traits;
+				EigenBinaryBlockHeader header;
+				std::memcpy(header.magic, "EIGB", 4);
+				header.scalarType = detail::EigenBinaryScalarType<Scalar>::value;
+				header.kind = Traits::kind;
+				header.flags = Traits::flags;
+				header.reserved = 0;
+				header.count = count;
+				header.rows = rows;
+				header.cols = cols;
+				_os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+				const std::uint64_t bytes = std::uint64_t(count) * rows * cols * sizeof(Scalar);
+				if (bytes) {
+					_os.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+				}
+				static const char padding[8] = {0};
+				_os.write(padding, static_cast<std::streamsize>(detail::eigenBinaryPadding(bytes)));
+			}
+
+			std::ostream & _os;
+	};
+
+	/** @brief A block read in place by EigenBinaryReader: a sequence of
+		objects of type T, each accessed through an Eigen::Map.
+	*/
+	template<typename T>
+	class EigenBinaryBlock {
+		public:
+			typedef typename detail::EigenBinaryTraits<T>::ScalarType Scalar;
+			typedef Eigen::Map<const T> MapType;
+
+			EigenBinaryBlock(Scalar const * data, std::size_t count, std::size_t rows, std::size_t cols)
+				: _data(data), _count(count), _rows(rows), _cols(cols) {}
+
+			std::size_t size() const {
+				return _count;
+			}
+
+			MapType operator[](std::size_t i) const {
+				return _map(_data + i * _rows * _cols);
+			}
+
+		private:
+			template<typename U = T>
+			typename std::enable_if < detail::EigenBinaryTraits<U>::kind == EigenBinaryBlockHeader::KIND_QUATERNION, MapType >::type
+			_map(Scalar const * p) const {
+				return MapType(p);
+			}
+
+			template<typename U = T>
+			typename std::enable_if < detail::EigenBinaryTraits<U>::kind != EigenBinaryBlockHeader::KIND_QUATERNION, MapType >::type
+			_map(Scalar const * p) const {
+				return MapType(p, _rows, _cols);
+			}
+
+			Scalar const * _data;
+			std::size_t _count;
+			std::size_t _rows;
+			std::size_t _cols;
+	};
+
+	/** @brief Reads blocks written by EigenBinaryWriter from memory, without
+		copying: results are Eigen::Maps into the buffer.
+
+		The buffer must stay valid while the maps are in use. Block data is
+		8-byte aligned relative to the start of the buffer.
+	*/
+	class EigenBinaryReader {
+		public:
+			/// @throws std::runtime_error on big-endian hosts.
+			EigenBinaryReader(const void * data, std::size_t len)
+				: _cursor(static_cast<const char *>(data))
+				, _end(_cursor + len) {
+				detail::eigenBinaryRequireLittleEndian();
+			}
+
+			bool atEnd() const {
+				return _cursor == _end;
+			}
+
+			/// @brief Get the header of the next block without consuming it.
+			/// @throws std::runtime_error if there is no valid header left.
+			EigenBinaryBlockHeader const& peek() const {
+				if (std::size_t(_end - _cursor) < sizeof(EigenBinaryBlockHeader)
+				        || std::memcmp(_cursor, "EIGB", 4) != 0) {
+					throw std::runtime_error("No valid Eigen binary block header!");
+				}
+				return *reinterpret_cast<EigenBinaryBlockHeader const *>(_cursor);
+			}
+
+			/// @brief Consume the next block as a sequence of T.
+			/// @throws std::runtime_error if the block does not hold T or is
+			/// truncated.
+			template<typename T>
+			EigenBinaryBlock<T> readBlock() {
+				typedef detail::EigenBinaryTraits<T> Traits;
+				typedef typename Traits::ScalarType Scalar;
+				EigenBinaryBlockHeader const& header = peek();
+				const bool isVector = header.rows == 1 || header.cols == 1;
+				if (header.scalarType != detail::EigenBinaryScalarType<Scalar>::value
+				        || header.kind != Traits::kind
+				        || (!isVector && header.flags != Traits::flags)
+				        || !detail::eigenBinaryDimensionMatches(Traits::rowsAtCompileTime, header.rows)
+				        || !detail::eigenBinaryDimensionMatches(Traits::colsAtCompileTime, header.cols)) {
+					throw std::runtime_error("Eigen binary block does not match the requested type!");
+				}
+				const std::uint64_t available = std::uint64_t(_end - _cursor) - sizeof(header);
+				// Bound each dimension first so the element size cannot wrap.
+				// An empty block holds no data, so its dimensions are never used.
+				const std::uint64_t maxScalars = available / sizeof(Scalar);
+				if (header.count && (header.rows > maxScalars || header.cols > maxScalars
+				                     || (header.rows && header.cols > maxScalars / header.rows))) {
+					throw std::runtime_error("Eigen binary block is truncated!");
+				}
+				const std::uint64_t elementBytes = header.rows * header.cols * sizeof(Scalar);
+				if (elementBytes && header.count > available / elementBytes) {
+					throw std::runtime_error("Eigen binary block is truncated!");
+				}
+				const std::uint64_t bytes = header.count * elementBytes;
+				const std::uint64_t padded = bytes + detail::eigenBinaryPadding(bytes);
+				if (padded > available) {
+					throw std::runtime_error("Eigen binary block is truncated!");
+				}
+				EigenBinaryBlock<T> ret(reinterpret_cast<Scalar const *>(_cursor + sizeof(header)),
+				                        static_cast<std::size_t>(header.count),
+				                        static_cast<std::size_t>(header.rows),
+				                        static_cast<std::size_t>(header.cols));
+				_cursor += sizeof(header) + padded;
+				return ret;
+			}
+
+			/// @brief Consume the next block, which must hold exactly one T,
+			/// and map it in place.
+			template<typename T>
+			Eigen::Map<const T> readMap() {
+				if (peek().count != 1) {
+					throw std::runtime_error("Eigen binary block does not hold exactly one object!");
+				}
+				return readBlock<T>()[0];
+			}
+
+			/// @brief Consume the next block, which must hold exactly one T,
+			/// and copy it into t (resizing it if dynamic).
+			template<typename T>
+			void read(T & t) {
+				t = readMap<T>();
+			}
+
+		private:
+			const char * _cursor;
+			const char * _end;
+	};
+
+/// @}
+
+} // end of namespace util
+
+#endif // INCLUDED_EigenBinarySerialize_h_GUID_07c1bc6f_db8c_4719_a7b2_562ab09b0a27
@@ -1,5 +1,12 @@
 /** @file
-	@brief Header
+	@brief Header providing boost::serialization support for Eigen matrices,
+	arrays, maps, blocks, quaternions and transforms.
+
+	Coefficients are stored in the object's own storage order, so load into
+	the same type (or a Map or Block of it) as was saved. Dynamic-size
+	objects are preceded by their rows and columns, and loading resizes
+	them; fixed-size ones are stored as bare coefficients, as they always
+	have been. Loading goes directly into the destination's storage.
 
 	@versioninfo@
 
@@ -27,17 +34,234 @@
 
 // Library/third-party includes
 #include <Eigen/Core>
+#include <Eigen/Geometry>
 #include <boost/serialization/array.hpp>
+#include <boost/serialization/level.hpp>
+#include <boost/serialization/split_free.hpp>
+#include <boost/serialization/tracking.hpp>
 
 // Standard includes
-// - none
+#include <cstddef>
+#include <stdexcept>
+
+namespace util {
+	namespace detail {
+		/// @internal
+		/// @brief Whether the size of an Eigen type is only known at runtime,
+		/// in which case its rows and columns are serialized before its
+		/// coefficients.
+		template<typename Derived>
+		struct EigenHasDynamicSize {
+			enum {
+				value = (Derived::RowsAtCompileTime == Eigen::Dynamic || Derived::ColsAtCompileTime == Eigen::Dynamic)
+			};
+		};
+
+		/// @internal
+		/// @brief Serializes (in either direction) the coefficients of a
+		/// direct-access Eigen object in place, always in column-major order,
+		/// so data may be loaded into an object of either storage order.
+		///
+		/// When that is the storage order, the coefficients go as one array
+		/// if contiguous, otherwise an array per column or, failing that,
+		/// one coefficient at a time. Row-major matrices (with more than one
+		/// row and column) go one coefficient at a time.
+		template<typename Archive, typename Derived>
+		inline void serializeEigenCoefficients(Archive & ar, Derived & m) {
+			if (Derived::IsRowMajor && m.rows() > 1 && m.cols() > 1) {
+				for (Eigen::DenseIndex j = 0; j < m.cols(); ++j) {
+					for (Eigen::DenseIndex i = 0; i < m.rows(); ++i) {
+						ar & m.coeffRef(i, j);
+					}
+				}
+				return;
+			}
+			const Eigen::DenseIndex inner = m.innerSize();
+			const Eigen::DenseIndex outer = m.outerSize();
+			if (m.innerStride() == 1 && (m.outerStride() == inner || outer <= 1)) {
+				ar & boost::serialization::make_array(m.data(), static_cast<std::size_t>(m.size()));
+			} else if (m.innerStride() == 1) {
+				for (Eigen::DenseIndex j = 0; j < outer; ++j) {
+					ar & boost::serialization::make_array(m.data() + j * m.outerStride(), static_cast<std::size_t>(inner));
+				}
+			} else {
+				for (Eigen::DenseIndex j = 0; j < outer; ++j) {
+					for (Eigen::DenseIndex i = 0; i < inner; ++i) {
+						ar & m.data()[j * m.outerStride() + i * m.innerStride()];
+					}
+				}
+			}
+		}
+
+		/// @internal
+		template<typename Archive, typename Derived>
+		inline void saveEigenDense(Archive & ar, Derived const& m) {
+			if (EigenHasDynamicSize<Derived>::value) {
+				const Eigen::DenseIndex rows = m.rows();
+				const Eigen::DenseIndex cols = m.cols();
+				ar << rows;
+				ar << cols;
+			}
+			serializeEigenCoefficients(ar, m);
+		}
+
+		/// @internal
+		/// @brief Whether a serialized dimension can be loaded into one
+		/// whose size at compile time is compileTimeSize.
+		inline bool eigenDimensionLoadable(int compileTimeSize, Eigen::DenseIndex size) {
+			return size >= 0 && (compileTimeSize == Eigen::Dynamic || size == compileTimeSize);
+		}
+
+		/// @internal
+		/// @brief Loads into a plain matrix or array, resizing it if
+		/// needed (which only reallocates if the size changes).
+		template<typename Archive, typename Derived>
+		inline void loadEigenPlain(Archive & ar, Derived & m) {
+			if (EigenHasDynamicSize<Derived>::value) {
+				Eigen::DenseIndex rows;
+				Eigen::DenseIndex cols;
+				ar >> rows;
+				ar >> cols;
+				if (!eigenDimensionLoadable(Derived::RowsAtCompileTime, rows)
+				        || !eigenDimensionLoadable(Derived::ColsAtCompileTime, cols)) {
+					throw std::runtime_error("Size of serialized Eigen object is invalid for the type loaded into!");
+				}
+				m.resize(rows, cols);
+			}
+			serializeEigenCoefficients(ar, m);
+		}
+
+		/// @internal
+		/// @brief Loads into a map or block, which cannot be resized, so
+		/// must already have the size being loaded.
+		template<typename Archive, typename Derived>
+		inline void loadEigenView(Archive & ar, Derived & m) {
+			if (EigenHasDynamicSize<Derived>::value) {
+				Eigen::DenseIndex rows;
+				Eigen::DenseIndex cols;
+				ar >> rows;
+				ar >> cols;
+				if (rows != m.rows() || cols != m.cols()) {
+					throw std::runtime_error("Size of serialized Eigen object does not match the Map or Block loaded into!");
+				}
+			}
+			serializeEigenCoefficients(ar, m);
+		}
+	} // end of namespace detail
+} // end of namespace util
 
 namespace boost {
 	namespace serialization {
 
-		template<class Archive, class Scalar, int RowsAtCompileTime, int ColsAtCompileTime>
-		void serialize(Archive & ar, ::Eigen::Matrix<Scalar, RowsAtCompileTime, ColsAtCompileTime> & m, const unsigned int /*version*/) {
-			ar & boost::serialization::make_array(m.data(), RowsAtCompileTime * ColsAtCompileTime);
+		template<class Archive, class Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+		void save(Archive & ar, ::Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols> const& m, const unsigned int /*version*/) {
+			::util::detail::saveEigenDense(ar, m);
+		}
+
+		template<class Archive, class Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+		void load(Archive & ar, ::Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols> & m, const unsigned int /*version*/) {
+			::util::detail::loadEigenPlain(ar, m);
+		}
+
+		template<class Archive, class Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+		void serialize(Archive & ar, ::Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols> & m, const unsigned int version) {
+			split_free(ar, m, version);
+		}
+
+		template<class Archive, class Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+		void save(Archive & ar, ::Eigen::Array<Scalar, Rows, Cols, Options, MaxRows, MaxCols> const& m, const unsigned int /*version*/) {
+			::util::detail::saveEigenDense(ar, m);
+		}
+
+		template<class Archive, class Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+		void load(Archive & ar, ::Eigen::Array<Scalar, Rows, Cols, Options, MaxRows, MaxCols> & m, const unsigned int /*version*/) {
+			::util::detail::loadEigenPlain(ar, m);
+		}
+
+		template<class Archive, class Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+		void serialize(Archive & ar, ::Eigen::Array<Scalar, Rows, Cols, Options, MaxRows, MaxCols> & m, const unsigned int version) {
+			split_free(ar, m, version);
+		}
+
+		template<class Archive, class PlainObjectType, int MapOptions, class StrideType>
+		void save(Archive & ar, ::Eigen::Map<PlainObjectType, MapOptions, StrideType> const& m, const unsigned int /*version*/) {
+			::util::detail::saveEigenDense(ar, m);
+		}
+
+		template<class Archive, class PlainObjectType, int MapOptions, class StrideType>
+		void load(Archive & ar, ::Eigen::Map<PlainObjectType, MapOptions, StrideType> & m, const unsigned int /*version*/) {
+			::util::detail::loadEigenView(ar, m);
+		}
+
+		template<class Archive, class PlainObjectType, int MapOptions, class StrideType>
+		void serialize(Archive & ar, ::Eigen::Map<PlainObjectType, MapOptions, StrideType> & m, const unsigned int version) {
+			split_free(ar, m, version);
+		}
+
+		/// Blocks of matrices, arrays or maps (anything with direct access)
+		template<class Archive, class XprType, int BlockRows, int BlockCols, bool InnerPanel>
+		void save(Archive & ar, ::Eigen::Block<XprType, BlockRows, BlockCols, InnerPanel> const& m, const unsigned int /*version*/) {
+			::util::detail::saveEigenDense(ar, m);
+		}
+
+		template<class Archive, class XprType, int BlockRows, int BlockCols, bool InnerPanel>
+		void load(Archive & ar, ::Eigen::Block<XprType, BlockRows, BlockCols, InnerPanel> & m, const unsigned int /*version*/) {
+			::util::detail::loadEigenView(ar, m);
+		}
+
+		template<class Archive, class XprType, int BlockRows, int BlockCols, bool InnerPanel>
+		void serialize(Archive & ar, ::Eigen::Block<XprType, BlockRows, BlockCols, InnerPanel> & m, const unsigned int version) {
+			split_free(ar, m, version);
+		}
+
+		/// Quaternions and transforms are small values, so skip class
+		/// information and tracking: this also keeps Boost from
+		/// instantiating heap allocation for them, which the bundled Eigen's
+		/// aligned operator delete does not support in C++11 mode.
+		///
+		/// These are the public implementation_level and tracking_level
+		/// traits, partially specialized as Boost documents for templates,
+		/// since BOOST_CLASS_IMPLEMENTATION and BOOST_CLASS_TRACKING only
+		/// take a single type.
+		template<class Scalar, int Options>
+		struct implementation_level< ::Eigen::Quaternion<Scalar, Options> > {
+			typedef mpl::integral_c_tag tag;
+			typedef mpl::int_<object_serializable> type;
+			BOOST_STATIC_CONSTANT(int, value = implementation_level::type::value);
+		};
+
+		template<class Scalar, int Options>
+		struct tracking_level< ::Eigen::Quaternion<Scalar, Options> > {
+			typedef mpl::integral_c_tag tag;
+			typedef mpl::int_<track_never> type;
+			BOOST_STATIC_CONSTANT(int, value = tracking_level::type::value);
+		};
+
+		template<class Scalar, int Dim, int Mode, int Options>
+		struct implementation_level< ::Eigen::Transform<Scalar, Dim, Mode, Options> > {
+			typedef mpl::integral_c_tag tag;
+			typedef mpl::int_<object_serializable> type;
+			BOOST_STATIC_CONSTANT(int, value = implementation_level::type::value);
+		};
+
+		template<class Scalar, int Dim, int Mode, int Options>
+		struct tracking_level< ::Eigen::Transform<Scalar, Dim, Mode, Options> > {
+			typedef mpl::integral_c_tag tag;
+			typedef mpl::int_<track_never> type;
+			BOOST_STATIC_CONSTANT(int, value = tracking_level::type::value);
+		};
+
+		/// Quaternions are stored as their coefficients, x, y, z, w.
+		template<class Archive, class Scalar, int Options>
+		void serialize(Archive & ar, ::Eigen::Quaternion<Scalar, Options> & q, const unsigned int /*version*/) {
+			ar & boost::serialization::make_array(q.coeffs().data(), 4);
+		}
+
+		/// Transforms are stored as the coefficients of their matrix.
+		template<class Archive, class Scalar, int Dim, int Mode, int Options>
+		void serialize(Archive & ar, ::Eigen::Transform<Scalar, Dim, Mode, Options> & t, const unsigned int /*version*/) {
+			typedef typename ::Eigen::Transform<Scalar, Dim, Mode, Options>::MatrixType MatrixType;
+			ar & boost::serialization::make_array(t.data(), MatrixType::SizeAtCompileTime);
 		}
 
 	} // end of namespace serialization
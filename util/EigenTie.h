@@ -1,11 +1,18 @@
 /** @file
 	@brief Header
 
+	Tying scalars into a vector is checked at compile time (the number of
+	variables must match the dimension), and assignment is unrolled into one
+	store per variable, so a tie costs nothing beyond the stores themselves.
+	The same fields of every struct in an array of structs can also be tied
+	into a matrix with util::tieFields(). Requires C++11.
+
 	Define UTIL_EIGEN_TIE_UNIQUE_ASSIGN_ASSERT or UTIL_EIGEN_TIE_UNIQUE_ASSIGN_EXCEPTION
-	to enable a debug-mode run-time	check that all tied variables are unique
-	when a tie is assigned to. This is fairly computationally expensive.
-	(std::set construction from iterators used to count unique pointers,
-	n log n for a tie of dimension n)
+	to enable a debug-mode run-time check that all tied variables are unique
+	when a tie is assigned to. The variables are compared once, when the tie
+	is constructed (n^2 pointer comparisons for a tie of dimension n, without
+	allocating), and the result is checked on each assignment, so tying a
+	variable more than once is still fine for a tie only used as a value.
 
 	@date 2011
 
@@ -28,22 +35,34 @@
 #ifndef INCLUDED_EigenTie_h_GUID_6c867047_6869_440c_8724_0d7733c6c7cd
 #define INCLUDED_EigenTie_h_GUID_6c867047_6869_440c_8724_0d7733c6c7cd
 
-// Internal Includes
-// - none
-
 // Library/third-party includes
 #include <Eigen/Core>
 
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+/// Defined if ties of any length, util::tie() and util::tieFields() are
+/// available: otherwise, only TieVector and tie() for up to 4 variables.
+#	define UTIL_EIGEN_TIE_VARIADIC
+#endif
+
+// Internal Includes
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+#	include <util/IndexSequence.h>
+#endif
+
 // Standard includes
-// - none
+#include <cstddef>
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+#	include <type_traits>
+#	include <vector>
+#endif
+
 #if (defined(UTIL_EIGEN_TIE_UNIQUE_ASSIGN_ASSERT) || defined(UTIL_EIGEN_TIE_UNIQUE_ASSIGN_EXCEPTION)) && !defined(NDEBUG)
 #	define UTIL_EIGEN_TIE_UNIQUE_ASSIGN_DO_CHECK
-#	include <set>
 namespace util {
 	namespace {
 		/// Utility function used when one of the unique assign checks is enabled.
 		/// @relates TieVector
-		void checkSameDimensions(int uniqueElts, int tieDimension);
+		void checkTieIsUnique(bool unique);
 	}
 }
 #endif
@@ -62,9 +81,24 @@ namespace util {
 		template<int _Dim, typename _Scalar1, typename _Scalar2>
 		bool operator==(TieVector<_Dim, _Scalar1> const& lhs, TieVector<_Dim, _Scalar2> const& rhs);
 
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+		/// Metafunction: true if every type in Ts is Scalar, used to give a
+		/// readable error when tying variables of mixed types.
+		template<typename Scalar, typename... Ts>
+		struct TieArgumentsMatch : std::true_type {};
+
+		template<typename Scalar, typename T, typename... Ts>
+		struct TieArgumentsMatch<Scalar, T, Ts...>
+			: std::integral_constant < bool, std::is_same<Scalar, T>::value && TieArgumentsMatch<Scalar, Ts...>::value > {};
+
+		/// Array type whose brace-initialization is used to expand an
+		/// expression for each index of a pack, in order.
+		typedef int TieExpansion[];
+#endif // UTIL_EIGEN_TIE_VARIADIC
+
 		/// Template class used to implement tying scalar variables or variable references
 		/// together to interoperate (as lvalue or value) with vector math classes in Eigen.
-		/// Construct these using util::TieVector() template functions.
+		/// Construct these using util::tie() or util::TieVector() template functions.
 		template<int _Dim = 3, typename _Scalar = double>
 		class TieVector {
 			public:
@@ -74,7 +108,31 @@ namespace util {
 				};
 				typedef Eigen::Matrix<_Scalar, _Dim, 1> Base;
 			private:
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+				static_assert(Dim > 0, "A TieVector must tie at least one variable");
+#endif
+
 				Scalar * _data[Dim];
+				/// Whether the tied variables are distinct: only computed when
+				/// one of the unique assign checks is enabled, but always a
+				/// member so the layout does not depend on the configuration.
+				bool _unique;
+
+				bool _computeUnique() const {
+					for (int i = 1; i < Dim; ++i) {
+						for (int j = 0; j < i; ++j) {
+							if (_data[i] == _data[j]) {
+								return false;
+							}
+						}
+					}
+					return true;
+				}
+#if defined(UTIL_EIGEN_TIE_UNIQUE_ASSIGN_DO_CHECK)
+#	define UTIL_EIGEN_TIE_COMPUTE_UNIQUE() _unique = _computeUnique()
+#else
+#	define UTIL_EIGEN_TIE_COMPUTE_UNIQUE() _unique = true
+#endif
 
 				/// Internal method used for setting a tie vector from an eigen vector
 				template<typename OtherDerived>
@@ -82,41 +140,80 @@ namespace util {
 					EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(OtherDerived, int(Dim));
 
 #if defined(UTIL_EIGEN_TIE_UNIQUE_ASSIGN_DO_CHECK)
-					std::set<Scalar *> uniqueElements(_data, _data + Dim);
-					checkSameDimensions(static_cast<int>(uniqueElements.size()), Dim);
+					checkTieIsUnique(_unique);
 #endif
-
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+					_scatter(other, make_index_sequence<Dim>());
+#else
 					for (int i = 0; i < Dim; ++i) {
 						*(_data[i]) = other[i];
 					}
+#endif
 					return *this;
 				}
 
 				template<int _D, typename _S>
 				friend class TieVector;
 
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+
+				/// Unrolled store of each coefficient through its pointer
+				template<typename OtherDerived, std::size_t... Is>
+				EIGEN_STRONG_INLINE void _scatter(::Eigen::MatrixBase<OtherDerived> const& other, index_sequence<Is...>) {
+					(void)TieExpansion {0, (*(_data[Is]) = other[Is], 0)...};
+				}
+
+				/// Unrolled load of each coefficient through its pointer
+				template<std::size_t... Is>
+				EIGEN_STRONG_INLINE Base _gather(index_sequence<Is...>) const {
+					Base temp;
+					(void)TieExpansion {0, (temp[Is] = *(_data[Is]), 0)...};
+					return temp;
+				}
+
+				/// Private constructor used for chained syntax
+				TieVector(TieVector < Dim - 1, Scalar > const& prev, Scalar & newVal)
+					: TieVector(prev, newVal, make_index_sequence < Dim - 1 > ()) {}
+
+				template<std::size_t... Is>
+				TieVector(TieVector < Dim - 1, Scalar > const& prev, Scalar & newVal, index_sequence<Is...>)
+					: _data{prev._data[Is]..., &newVal} {
+					UTIL_EIGEN_TIE_COMPUTE_UNIQUE();
+				}
+
+			public:
+				/// Constructor from exactly Dim variables of type Scalar.
+				template<typename... Rest>
+				TieVector(Scalar & x0, Rest & ... rest) : _data{&x0, &rest...} {
+					static_assert(sizeof...(Rest) + 1 == Dim, "YOU_DID_NOT_PASS_THE_CORRECT_AMOUNT_OF_ARGUMENTS_TO_TIE_TOGETHER");
+					static_assert(TieArgumentsMatch<Scalar, Rest...>::value, "ALL_VARIABLES_TIED_TOGETHER_MUST_HAVE_THE_SAME_TYPE");
+					UTIL_EIGEN_TIE_COMPUTE_UNIQUE();
+				}
+#else // UTIL_EIGEN_TIE_VARIADIC
 				/// Private constructor used for chained syntax
 				TieVector(TieVector < Dim - 1, Scalar > const& prev, Scalar & newVal) {
 					for (int i = 0; i < Dim - 1; ++i) {
 						_data[i] = prev._data[i];
 					}
 					_data[Dim - 1] = &newVal;
+					UTIL_EIGEN_TIE_COMPUTE_UNIQUE();
 				}
 
 			public:
-#define EIGEN_TIE_STATIC_ASSERT_DIMENSION(_NUMARGS) assert(Dim == _NUMARGS && "YOU_DID_NOT_PASS_THE_CORRECT_AMOUNT_OF_ARGUMENTS_TO_TIE_TOGETHER")
-//#define EIGEN_TIE_STATIC_ASSERT_DIMENSION(_NUMARGS) EIGEN_STATIC_ASSERT( (int(Dim) == int(_NUMARGS)), YOU_DID_NOT_PASS_THE_CORRECT_AMOUNT_OF_ARGUMENTS_TO_TIE_TOGETHER)
+#define EIGEN_TIE_STATIC_ASSERT_DIMENSION(_NUMARGS) EIGEN_STATIC_ASSERT( (int(Dim) == int(_NUMARGS)), THIS_METHOD_IS_ONLY_FOR_VECTORS_OF_A_SPECIFIC_SIZE)
 #define EIGEN_TIE_INITIALIZE_ELEMENT(_ELT) _data[_ELT] = &x ## _ELT
 
 				TieVector(Scalar & x0) {
 					EIGEN_TIE_STATIC_ASSERT_DIMENSION(1);
 					EIGEN_TIE_INITIALIZE_ELEMENT(0);
+					UTIL_EIGEN_TIE_COMPUTE_UNIQUE();
 				}
 
 				TieVector(Scalar & x0, Scalar & x1) {
 					EIGEN_TIE_STATIC_ASSERT_DIMENSION(2);
 					EIGEN_TIE_INITIALIZE_ELEMENT(0);
 					EIGEN_TIE_INITIALIZE_ELEMENT(1);
+					UTIL_EIGEN_TIE_COMPUTE_UNIQUE();
 				}
 
 				TieVector(Scalar & x0, Scalar & x1, Scalar & x2) {
@@ -124,6 +221,7 @@ namespace util {
 					EIGEN_TIE_INITIALIZE_ELEMENT(0);
 					EIGEN_TIE_INITIALIZE_ELEMENT(1);
 					EIGEN_TIE_INITIALIZE_ELEMENT(2);
+					UTIL_EIGEN_TIE_COMPUTE_UNIQUE();
 				}
 
 				TieVector(Scalar & x0, Scalar & x1, Scalar & x2, Scalar & x3) {
@@ -132,10 +230,14 @@ namespace util {
 					EIGEN_TIE_INITIALIZE_ELEMENT(1);
 					EIGEN_TIE_INITIALIZE_ELEMENT(2);
 					EIGEN_TIE_INITIALIZE_ELEMENT(3);
+					UTIL_EIGEN_TIE_COMPUTE_UNIQUE();
 				}
 
 #undef EIGEN_TIE_INITIALIZE_ELEMENT
 #undef EIGEN_TIE_STATIC_ASSERT_DIMENSION
+#endif // UTIL_EIGEN_TIE_VARIADIC
+
+#undef UTIL_EIGEN_TIE_COMPUTE_UNIQUE
 
 				/// Assignment operator from another equal-sized tie vector
 				/// assigns the values, not the tie references, by converting
@@ -157,11 +259,15 @@ namespace util {
 
 				/// Returns a copy of the TieVector current value as a fixed-size Eigen::Vector
 				EIGEN_STRONG_INLINE Base convert() const {
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+					return _gather(make_index_sequence<Dim>());
+#else
 					Base temp;
 					for (int i = 0; i < Dim; ++i) {
 						temp[i] = *(_data[i]);
 					}
 					return temp;
+#endif
 				}
 
 				/// Conversion operator to a fixed-size Eigen::Vector
@@ -236,35 +342,209 @@ namespace util {
 			return !(tieVal == other);
 		}
 
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+
+		/// Template class used to tie the same Dim fields of every struct in
+		/// an array of structs into a Dim x N matrix, so Eigen math can run
+		/// directly over array-of-structs storage: each column is one struct.
+		/// Construct these using util::tieFields().
+		///
+		/// Each field is a strided row of the matrix. When the fields are
+		/// evenly spaced within the struct (like x, y, z members declared
+		/// together), the whole view is a single strided Eigen::Map, so
+		/// gathers and scatters are one Eigen assignment; otherwise they are
+		/// done a row at a time.
+		///
+		/// Like assigning to an Eigen::Map, the right-hand side of an
+		/// assignment is not evaluated into a temporary first: call .eval()
+		/// on it if it reads from the structs being written.
+		template<int _Dim, typename _Scalar>
+		class StridedTieMatrix {
+			public:
+				typedef _Scalar Scalar;
+				enum {
+					Dim = _Dim
+				};
+				typedef ::Eigen::DenseIndex Index;
+				typedef Eigen::Matrix<Scalar, Dim, Eigen::Dynamic> Base;
+				typedef Eigen::Map<Eigen::Matrix<Scalar, 1, Eigen::Dynamic>, Eigen::Unaligned, Eigen::InnerStride<Eigen::Dynamic> > RowMap;
+				typedef Eigen::Map<Base, Eigen::Unaligned, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > MatrixMap;
+
+				/// @param fields Pointer to each field of the first struct
+				/// @param count Number of structs
+				/// @param stride Distance between consecutive structs, in Scalars
+				StridedTieMatrix(Scalar * const (&fields)[Dim], Index count, Index stride)
+					: _count(count)
+					, _stride(stride)
+					, _fieldSpacing(0) {
+					for (int i = 0; i < Dim; ++i) {
+						_fields[i] = fields[i];
+					}
+					Index spacing = (Dim > 1) ? Index(_fields[1] - _fields[0]) : 1;
+					bool even = spacing > 0;
+					for (int i = 2; even && i < Dim; ++i) {
+						even = (_fields[i] - _fields[i - 1]) == spacing;
+					}
+					if (even) {
+						_fieldSpacing = spacing;
+					}
+				}
+
+				Index rows() const {
+					return Dim;
+				}
+
+				Index cols() const {
+					return _count;
+				}
+
+				/// Strided view of one field across all structs
+				RowMap row(int i) const {
+					return RowMap(_fields[i], _count, Eigen::InnerStride<Eigen::Dynamic>(_stride));
+				}
+
+				/// True if the fields are evenly spaced, so matrix() may be used.
+				bool isSingleMap() const {
+					return _fieldSpacing != 0;
+				}
+
+				/// Strided view of the whole array: only valid if isSingleMap()
+				MatrixMap matrix() const {
+					eigen_assert(isSingleMap());
+					return Base::IsRowMajor ?
+					       MatrixMap(_fields[0], Dim, _count, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(_fieldSpacing, _stride)) :
+					       MatrixMap(_fields[0], Dim, _count, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(_stride, _fieldSpacing));
+				}
+
+				/// Tie of the fields of struct j
+				EIGEN_STRONG_INLINE TieVector<Dim, Scalar> operator[](Index j) const {
+					return _tieColumn(j, make_index_sequence<Dim>());
+				}
+
+				/// Scatter: assign a Dim x N Eigen matrix or expression into the fields.
+				template<typename OtherDerived>
+				StridedTieMatrix & operator=(::Eigen::MatrixBase<OtherDerived> const& other) {
+					EIGEN_STATIC_ASSERT(int(OtherDerived::RowsAtCompileTime) == int(Dim) || int(OtherDerived::RowsAtCompileTime) == Eigen::Dynamic,
+					                    YOU_MIXED_MATRICES_OF_DIFFERENT_SIZES);
+					eigen_assert(other.rows() == Dim && other.cols() == _count);
+					if (isSingleMap()) {
+						matrix() = other;
+					} else {
+						for (int i = 0; i < Dim; ++i) {
+							row(i) = other.row(i);
+						}
+					}
+					return *this;
+				}
+
+				/// Assigns the values, not the references: the source is gathered first.
+				StridedTieMatrix & operator=(StridedTieMatrix const& other) {
+					if (this == &other) {
+						return *this;
+					}
+					return *this = other.convert();
+				}
+
+				/// Gather: returns a copy of the fields as a Dim x N Eigen matrix
+				Base convert() const {
+					Base ret(int(Dim), _count);
+					if (isSingleMap()) {
+						ret = matrix();
+					} else {
+						for (int i = 0; i < Dim; ++i) {
+							ret.row(i) = row(i);
+						}
+					}
+					return ret;
+				}
+
+				/// Conversion operator to a Dim x N Eigen matrix
+				operator Base() const {
+					return convert();
+				}
+
+			private:
+				template<std::size_t... Is>
+				EIGEN_STRONG_INLINE TieVector<Dim, Scalar> _tieColumn(Index j, index_sequence<Is...>) const {
+					return TieVector<Dim, Scalar>(_fields[Is][j * _stride]...);
+				}
+
+				Scalar * _fields[Dim];
+				Index _count;
+				Index _stride;
+				/// Distance between consecutive fields in Scalars, or 0 if uneven.
+				Index _fieldSpacing;
+		};
+#endif // UTIL_EIGEN_TIE_VARIADIC
+
 	} // end of namespace detail
 
-#define EIGEN_TIE_DEFINE_CREATION_FUNCTION( _DIM, _ARGS, _ARGNAMES) \
-	template<typename Scalar> \
-	EIGEN_STRONG_INLINE detail::TieVector<_DIM, Scalar> TieVector _ARGS { \
-		return detail::TieVector<_DIM, Scalar> _ARGNAMES ; \
-	} \
+#ifdef UTIL_EIGEN_TIE_VARIADIC
+	/// Ties any number of variables of the same scalar type together into
+	/// an lvalue/value that interoperates with fixed-size Eigen vectors:
+	/// e.g. util::tie(x, y, z) = Eigen::Vector3d(1, 2, 3);
+	template<typename Scalar, typename... Rest>
+	EIGEN_STRONG_INLINE detail::TieVector < sizeof...(Rest) + 1, Scalar > tie(Scalar & x0, Rest & ... rest) {
+		return detail::TieVector < sizeof...(Rest) + 1, Scalar > (x0, rest...);
+	}
 
-	EIGEN_TIE_DEFINE_CREATION_FUNCTION(1,
-	                                   (Scalar & x0),
-	                                   (x0)
-	                                  )
+	/// Older name for util::tie()
+	template<typename Scalar, typename... Rest>
+	EIGEN_STRONG_INLINE detail::TieVector < sizeof...(Rest) + 1, Scalar > TieVector(Scalar & x0, Rest & ... rest) {
+		return detail::TieVector < sizeof...(Rest) + 1, Scalar > (x0, rest...);
+	}
 
-	EIGEN_TIE_DEFINE_CREATION_FUNCTION(2,
-	                                   (Scalar & x0, Scalar & x1),
-	                                   (x0, x1)
-	                                  )
+	/// Ties the given fields of each of count structs starting at first into
+	/// a Dim x count matrix lvalue/value, one column per struct, for gathering
+	/// and scattering Eigen matrices over an array of structs: e.g.
+	/// util::tieFields(particles, n, &Particle::x, &Particle::y, &Particle::z) = positions;
+	/// where positions is an Eigen::Matrix3Xd.
+	template<typename Struct, typename Scalar, typename... Rest>
+	inline detail::StridedTieMatrix < sizeof...(Rest) + 1, Scalar >
+	tieFields(Struct * first, std::size_t count, Scalar Struct::* field0, Rest Struct::* ... fields) {
+		static_assert(detail::TieArgumentsMatch<Scalar, Rest...>::value, "ALL_VARIABLES_TIED_TOGETHER_MUST_HAVE_THE_SAME_TYPE");
+		static_assert(sizeof(Struct) % sizeof(Scalar) == 0, "STRUCT_SIZE_MUST_BE_A_MULTIPLE_OF_THE_FIELD_SIZE_TO_TIE_ITS_FIELDS");
+		Scalar * ptrs[] = {first ? &(first->*field0) : nullptr, (first ? &(first->*fields) : nullptr)...};
+		return detail::StridedTieMatrix < sizeof...(Rest) + 1, Scalar > (ptrs, ::Eigen::DenseIndex(count),
+		        ::Eigen::DenseIndex(sizeof(Struct) / sizeof(Scalar)));
+	}
 
-	EIGEN_TIE_DEFINE_CREATION_FUNCTION(3,
-	                                   (Scalar & x0, Scalar & x1, Scalar & x2),
-	                                   (x0, x1, x2)
-	                                  )
+	/// Overload of tieFields() for all the structs in a std::vector.
+	template<typename Struct, typename Alloc, typename Scalar, typename... Rest>
+	inline detail::StridedTieMatrix < sizeof...(Rest) + 1, Scalar >
+	tieFields(std::vector<Struct, Alloc> & structs, Scalar Struct::* field0, Rest Struct::* ... fields) {
+		return tieFields(structs.empty() ? static_cast<Struct *>(nullptr) : &structs[0], structs.size(), field0, fields...);
+	}
 
-	EIGEN_TIE_DEFINE_CREATION_FUNCTION(4,
-	                                   (Scalar & x0, Scalar & x1, Scalar & x2, Scalar & x3),
-	                                   (x0, x1, x2, x3)
-	                                  )
+#else // UTIL_EIGEN_TIE_VARIADIC
+#define EIGEN_TIE_DEFINE_CREATION_FUNCTION(_NAME, _DIM, _ARGS, _ARGNAMES) \
+	template<typename Scalar> \
+	EIGEN_STRONG_INLINE detail::TieVector<_DIM, Scalar> _NAME _ARGS { \
+		return detail::TieVector<_DIM, Scalar> _ARGNAMES ; \
+	}
+
+	/// Ties up to 4 variables of the same scalar type together into an
+	/// lvalue/value that interoperates with fixed-size Eigen vectors:
+	/// e.g. util::tie(x, y, z) = Eigen::Vector3d(1, 2, 3);
+	/// Use the chained syntax util::tie(x)(y)... for longer ties.
+	/// @{
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(tie, 1, (Scalar & x0), (x0))
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(tie, 2, (Scalar & x0, Scalar & x1), (x0, x1))
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(tie, 3, (Scalar & x0, Scalar & x1, Scalar & x2), (x0, x1, x2))
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(tie, 4, (Scalar & x0, Scalar & x1, Scalar & x2, Scalar & x3), (x0, x1, x2, x3))
+	/// @}
+
+	/// Older name for util::tie()
+	/// @{
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(TieVector, 1, (Scalar & x0), (x0))
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(TieVector, 2, (Scalar & x0, Scalar & x1), (x0, x1))
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(TieVector, 3, (Scalar & x0, Scalar & x1, Scalar & x2), (x0, x1, x2))
+	EIGEN_TIE_DEFINE_CREATION_FUNCTION(TieVector, 4, (Scalar & x0, Scalar & x1, Scalar & x2, Scalar & x3), (x0, x1, x2, x3))
+	/// @}
 
 #undef EIGEN_TIE_DEFINE_CREATION_FUNCTION
+#endif // UTIL_EIGEN_TIE_VARIADIC
+
 /// @}
 
 } // end of namespace util
@@ -276,8 +556,8 @@ namespace util {
 
 namespace util {
 	namespace {
-		inline void checkSameDimensions(int uniqueElts, int tieDimension) {
-			if (uniqueElts != tieDimension) {
+		inline void checkTieIsUnique(bool unique) {
+			if (!unique) {
 				throw std::logic_error("A variable appears more than once in a vector tie that is being assigned to!");
 			}
 		}
@@ -287,8 +567,8 @@ namespace util {
 #		include <cassert>
 namespace util {
 	namespace {
-		inline void checkSameDimensions(int uniqueElts, int tieDimension) {
-			assert(uniqueElts == tieDimension && "A variable should not appear more than once in a vector tie that is being assigned to!");
+		inline void checkTieIsUnique(bool unique) {
+			assert(unique && "A variable should not appear more than once in a vector tie that is being assigned to!");
 		}
 	}
 }
@@ -24,61 +24,58 @@
 
 // Internal Includes
 #include "ValueToTemplatePolicy.h"
+#include <util/IndexSequence.h>
 
 // Library/third-party includes
 #include <boost/mpl/map.hpp>
 #include <boost/mpl/pair.hpp>
-#include <boost/mpl/insert.hpp>
 #include <boost/fusion/include/map.hpp>
-#include <boost/fusion/include/vector.hpp>
-#include <boost/fusion/include/at_c.hpp>
+#include <boost/fusion/include/advance.hpp>
 #include <boost/fusion/include/begin.hpp>
-#include <boost/fusion/include/end.hpp>
+#include <boost/fusion/include/deref.hpp>
+#include <boost/fusion/include/size.hpp>
+#include <boost/fusion/include/value_of.hpp>
 
 // Standard includes
-// - none
+#include <cstddef>
+#include <type_traits>
 
 namespace util {
 
 	namespace detail {
-		/// Class template used to perform recursive conversion of values in a fusion::map
-		/// to template parameters - delegates the actual conversion to SelectionPolicy
-		template<typename Iter, typename EndIter, typename Op, template<class> class SelectionPolicy, typename Params = boost::mpl::map<> >
-		struct ConvertElement {
-			typedef typename boost::fusion::result_of::first <
-			typename boost::fusion::result_of::value_of<Iter>::type
-			>::type KeyType;
-
-			typedef typename boost::fusion::result_of::second <
-			typename boost::fusion::result_of::value_of<Iter>::type
-			>::type ValueType;
-			typedef typename Op::result_type result_type;
-			typedef typename boost::fusion::result_of::next<Iter>::type NextIter;
-
-			template<typename Val>
-			struct Next {
-				typedef typename boost::mpl::insert<Params, boost::mpl::pair<KeyType, Val> >::type NewParams;
-				static inline result_type apply(boost::fusion::vector<NextIter, EndIter> arg) {
-					return ConvertElement<NextIter, EndIter, Op, SelectionPolicy, NewParams>::apply(boost::fusion::at_c<0>(arg), boost::fusion::at_c<1>(arg));
-				}
+		/// Builder for ValueToTemplateTable passing a boost::mpl::map from
+		/// each key to its template parameter.
+		template<typename... Keys>
+		struct MakeMplMap {
+			template<typename... Vals>
+			struct apply {
+				typedef boost::mpl::map<boost::mpl::pair<Keys, Vals>...> type;
 			};
-
-			static inline result_type apply(Iter input, EndIter end) {
-				return SelectionPolicy<ValueType>::template apply<result_type, Next>(deref(input).second, boost::fusion::vector<NextIter, EndIter>(boost::fusion::next(input), end));
-			}
-
 		};
 
-		/// Partial specialization for base case: have reached the end
-		/// of the map
-		template<typename EndIter, typename Op, template<class> class SelectionPolicy, typename Params>
-		struct ConvertElement<EndIter, EndIter, Op, SelectionPolicy, Params> {
-			typedef typename Op::result_type result_type;
-			static inline result_type apply(EndIter, EndIter) {
-				return Op::template apply<Params>();
+		/// Key and value types of element I of a fusion::map
+		template<typename Input, std::size_t I>
+		struct FusionMapElement {
+			typedef typename boost::fusion::result_of::advance_c <
+			typename boost::fusion::result_of::begin<Input const>::type, I >::type Iter;
+			typedef typename boost::fusion::result_of::value_of<Iter>::type Pair;
+			typedef typename boost::fusion::result_of::first<Pair>::type KeyType;
+			typedef typename std::decay<typename boost::fusion::result_of::second<Pair>::type>::type ValueType;
+
+			static inline Iter iter(Input const& input) {
+				return boost::fusion::advance_c<I>(boost::fusion::begin(input));
 			}
 		};
 
+		/// Dispatches on the values of a fusion::map
+		template<typename Op, template<class> class SelectionPolicy, typename Input, typename Fallback, std::size_t... Is>
+		inline typename Op::result_type convertFusionMap(Input const& input, Fallback & fallback, index_sequence<Is...>) {
+			typedef MakeMplMap<typename FusionMapElement<Input, Is>::KeyType...> Builder;
+			typedef ValueToTemplateTable < Op, Builder,
+			        SelectionPolicy<typename FusionMapElement<Input, Is>::ValueType>... > Table;
+			return dispatchOrFallback<Table>(input, fallback,
+			                                 boost::fusion::deref(FusionMapElement<Input, Is>::iter(input)).second...);
+		}
 	} // end of namespace detail
 
 	/// @addtogroup GenericProgramming Generic Programming
@@ -87,6 +84,9 @@ namespace util {
 	of the given metafunction with a mpl map template parameter equal
 	to the runtime values passed.
 
+	Like ValueToTemplate, dispatch is a single lookup in a table of every
+	combination of template parameters.
+
 	@sa ValueToTemplate
 
 	@tparam Op Class defining a static function template called "apply"
@@ -94,9 +94,20 @@ namespace util {
 	*/
 	template<typename Op, typename Input>
 	inline typename Op::result_type FusionMapToTemplate(Input const& input) {
-		typedef typename boost::fusion::result_of::begin<Input const>::type Iter;
-		typedef typename boost::fusion::result_of::end<Input const>::type EndIter;
-		return detail::ConvertElement<Iter, EndIter, Op, DefaultValueToTemplatePolicy>::apply(boost::fusion::begin(input), boost::fusion::end(input));
+		detail::NoValueToTemplateFallback fallback;
+		return detail::convertFusionMap<Op, DefaultValueToTemplatePolicy>(input, fallback,
+		        make_index_sequence<boost::fusion::result_of::size<Input>::value>());
+	}
+
+	/** @brief Like FusionMapToTemplate, but instead of throwing when a value
+	has no template parameter, returns fallback(input).
+
+	@sa ValueToTemplateWithFallback
+	*/
+	template<typename Op, typename Input, typename Fallback>
+	inline typename Op::result_type FusionMapToTemplateWithFallback(Input const& input, Fallback fallback) {
+		return detail::convertFusionMap<Op, DefaultValueToTemplatePolicy>(input, fallback,
+		        make_index_sequence<boost::fusion::result_of::size<Input>::value>());
 	}
 	/// @}
 
@@ -0,0 +1,86 @@
+/** @file
+	@brief Header providing a C++11 implementation of the C++14
+	std::index_sequence family, for expanding parameter packs and
+	unrolling fixed-size loops at compile time.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_IndexSequence_h_GUID_a67b659e_c7a5_43d5_9513_2503488fe63a
+#define INCLUDED_IndexSequence_h_GUID_a67b659e_c7a5_43d5_9513_2503488fe63a
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+
+namespace util {
+	/// @addtogroup Metaprogramming
+	/// @{
+
+	/// @brief A compile-time sequence of std::size_t values.
+	template<std::size_t... Is>
+	struct index_sequence {
+		typedef index_sequence type;
+		static constexpr std::size_t size() {
+			return sizeof...(Is);
+		}
+	};
+
+	namespace detail {
+		/// @brief Utility template used by make_index_sequence: appends the
+		/// second sequence, offset by the length of the first, to the first.
+		///
+		/// @internal
+		template<typename First, typename Second>
+		struct concat_index_sequence;
+
+		template<std::size_t... Is, std::size_t... Js>
+		struct concat_index_sequence<index_sequence<Is...>, index_sequence<Js...> >
+			: index_sequence < Is..., (sizeof...(Is) + Js)... > {};
+
+		/// @brief Utility template used by make_index_sequence: splits the
+		/// range in half so instantiation depth is logarithmic in N.
+		///
+		/// @internal
+		template<std::size_t N>
+		struct make_index_sequence_impl
+			: concat_index_sequence < typename make_index_sequence_impl < N / 2 >::type,
+			  typename make_index_sequence_impl < N - N / 2 >::type > {};
+
+		template<>
+		struct make_index_sequence_impl<0> : index_sequence<> {};
+
+		template<>
+		struct make_index_sequence_impl<1> : index_sequence<0> {};
+	} // end of namespace detail
+
+	/// @brief Alias for index_sequence<0, 1, ..., N - 1>
+	template<std::size_t N>
+	using make_index_sequence = typename detail::make_index_sequence_impl<N>::type;
+
+	/// @brief Alias for an index_sequence the length of a parameter pack.
+	template<typename... Ts>
+	using index_sequence_for = make_index_sequence<sizeof...(Ts)>;
+
+	/// @}
+} // end of namespace util
+
+#endif // INCLUDED_IndexSequence_h_GUID_a67b659e_c7a5_43d5_9513_2503488fe63a
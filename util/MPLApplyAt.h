@@ -27,16 +27,23 @@
 // - none
 
 // Library/third-party includes
-#include <boost/integer.hpp>
+#include <boost/config.hpp>
 #include <boost/mpl/at.hpp>
-#include <boost/mpl/int.hpp>
-#include <boost/mpl/less.hpp>
-#include <boost/mpl/size.hpp>
-#include <boost/mpl/bool.hpp>
 #include <boost/mpl/identity.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/mpl/is_sequence.hpp>
+#include <boost/mpl/size.hpp>
 
 // Standard includes
-// - none
+#include <cstddef>
+
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) && !defined(BOOST_NO_CXX11_TEMPLATE_ALIASES) \
+	&& !defined(BOOST_NO_CXX11_CONSTEXPR) && !defined(BOOST_NO_CXX11_DECLTYPE) && !defined(BOOST_NO_CXX11_NULLPTR)
+/// Defined if apply_at dispatches through a table and also accepts
+/// variadic type lists: otherwise, it is a binary search over MPL sequences.
+#	define UTIL_APPLY_AT_VARIADIC
+#	include <util/IndexSequence.h>
+#endif
 
 namespace util {
 	/// @addtogroup Metaprogramming
@@ -44,78 +51,135 @@ namespace util {
 
 	/// @internal
 	namespace detail {
-		/// @brief Utility template to call a functor's apply method, templated
-		/// on the MPL integral constant with value equal to that provided at runtime.
+		/// @brief Element access for an MPL sequence.
 		///
-		/// Iteration will find the appropriate constant in the half-open range
-		/// [0, Limit) by default. (Directly calling the templated apply method
-		/// with an alternate starting point is also possible)
+		/// @internal
+		template<typename Sequence>
+		struct mpl_sequence_elements {
+			static const std::size_t size = boost::mpl::size<Sequence>::type::value;
+
+			template<std::size_t I>
+			struct at {
+				typedef typename boost::mpl::at_c<Sequence, I>::type type;
+			};
+		};
+
+		/// @brief Calls a user-provided functor with the type T wrapped in
+		/// boost::mpl::identity as the only argument.
 		///
 		/// @internal
-		template<typename IntType, typename Limit, typename F>
-		struct runtime_int_to_type_impl {
-			private:
-				/// @brief Self typedef for convenience.
-				typedef runtime_int_to_type_impl<IntType, Limit, F> type;
-
-				/// @brief Metafunction to determine when to stop recursing
-				template<typename Current>
-				struct IsValidIndex : boost::mpl::less<Current, Limit>::type {};
-
-
-				/// @brief Main recursive function: checks for equality and either
-				/// runs functor or recurses with the next integer.
-				template<typename Current>
-				static void apply(IntType i, F op, boost::mpl::bool_<true> const&) {
-					if (Current::value == i) {
-						op.template operator()<Current>();
-					} else {
-						type::template apply<typename boost::mpl::next<Current>::type>(i, op);
-					}
-				}
+		template<typename F, typename T>
+		void apply_at_thunk(F & op) {
+			op.operator()(boost::mpl::identity<T>());
+		}
 
-				/// @brief "base case" - when we've reached the end of where we should
-				/// be iterating.
-				template<typename Current>
-				static void apply(IntType, F, boost::mpl::bool_<false> const&) {
-					/// @todo appropriate error behavior?
-				}
+#ifdef UTIL_APPLY_AT_VARIADIC
+		/// @brief One element of indexed_types
+		///
+		/// @internal
+		template<std::size_t I, typename T>
+		struct indexed_type {
+			typedef T type;
+		};
 
-			public:
-				/// @brief main entrance point: starts off at zero.
-				static void apply(IntType i, F op) {
-					typedef boost::mpl::int_<0> Zero;
-					type::template apply<Zero>(i, op);
-				}
+		/// @brief Inherits from indexed_type<I, T> for each element, so the
+		/// element at an index can be found by overload resolution instead
+		/// of recursion.
+		///
+		/// @internal
+		template<typename Indices, typename... Ts>
+		struct indexed_types;
 
-				/// @brief Utility trampoline for recursion: performs the application
-				/// of the validity check for tag-dispatching of recusive call or base case.
-				template<typename Current>
-				static void apply(IntType i, F op) {
-					type::template apply<Current>(i, op, IsValidIndex<Current>());
-				}
+		template<std::size_t... Is, typename... Ts>
+		struct indexed_types<index_sequence<Is...>, Ts...> : indexed_type<Is, Ts>... {};
 
+		template<std::size_t I, typename T>
+		indexed_type<I, T> select_indexed_type(indexed_type<I, T> const*);
+
+		/// @brief Element access for a variadic type list, such as
+		/// std::tuple<Ts...>, used as a type sequence without being instantiated.
+		///
+		/// @internal
+		template<typename Sequence>
+		struct type_list_elements;
+
+		template<template<class...> class List, typename... Ts>
+		struct type_list_elements<List<Ts...> > {
+			static const std::size_t size = sizeof...(Ts);
+
+			template<std::size_t I>
+			struct at {
+				typedef indexed_types<index_sequence_for<Ts...>, Ts...> all;
+				typedef typename decltype(select_indexed_type<I>(static_cast<all const*>(nullptr)))::type type;
+			};
 		};
 
-		/// @brief Utility struct for apply_at
+		/// @brief Chooses how to get the elements of a type sequence: MPL
+		/// sequences are detected with boost::mpl::is_sequence, and anything
+		/// else is treated as a variadic type list.
 		///
-		/// Templated functor with templated function call operator that
-		/// looks up the element at the given index, and calls the user-provided
-		/// functor with this type wrapped in boost::mpl::identity as the only
-		/// argument
+		/// @internal
+		template<typename Sequence>
+		struct sequence_elements
+			: boost::mpl::if_ < boost::mpl::is_sequence<Sequence>,
+			  mpl_sequence_elements<Sequence>,
+			  type_list_elements<Sequence> >::type {};
+
+		/// @brief Table-driven implementation of apply_at: the thunk for
+		/// each element of the sequence is generated at compile time, so a
+		/// call is a bounds check and an indirect call.
 		///
 		/// @internal
-		template<typename F, typename Sequence>
-		struct apply_at_functor_impl {
-			apply_at_functor_impl(F operation) : op(operation) {}
+		template<typename Elements, typename F, std::size_t... Is>
+		inline bool apply_at_impl(std::size_t i, F & op, index_sequence<Is...>) {
+			typedef void (*Thunk)(F &);
+			static const Thunk thunks[] = {&apply_at_thunk<F, typename Elements::template at<Is>::type>...};
+			if (i >= sizeof...(Is)) {
+				return false;
+			}
+			thunks[i](op);
+			return true;
+		}
 
-			template<typename Index>
-			void operator()() {
-				op.operator()(boost::mpl::identity<typename boost::mpl::at<Sequence, Index>::type >());
+		/// @brief Specialization for an empty sequence.
+		///
+		/// @internal
+		template<typename Elements, typename F>
+		inline bool apply_at_impl(std::size_t, F &, index_sequence<>) {
+			return false;
+		}
+#else // UTIL_APPLY_AT_VARIADIC
+		/// @brief Implementation of apply_at without C++11: a binary search
+		/// over the index range [Begin, End), unrolled at compile time, so a
+		/// call is about log2(size) comparisons.
+		///
+		/// Kind is 0 for an empty range, 1 for a single index, 2 otherwise.
+		///
+		/// @internal
+		template < typename Elements, typename F, std::size_t Begin, std::size_t End,
+		         int Kind = (End - Begin == 0 ? 0 : (End - Begin == 1 ? 1 : 2)) >
+		struct apply_at_search {
+			static void apply(std::size_t i, F & op) {
+				if (i < Begin + (End - Begin) / 2) {
+					apply_at_search < Elements, F, Begin, Begin + (End - Begin) / 2 >::apply(i, op);
+				} else {
+					apply_at_search < Elements, F, Begin + (End - Begin) / 2, End >::apply(i, op);
+				}
 			}
+		};
+
+		template<typename Elements, typename F, std::size_t Begin, std::size_t End>
+		struct apply_at_search<Elements, F, Begin, End, 1> {
+			static void apply(std::size_t, F & op) {
+				apply_at_thunk<F, typename Elements::template at<Begin>::type>(op);
+			}
+		};
 
-			F op;
+		template<typename Elements, typename F, std::size_t Begin, std::size_t End>
+		struct apply_at_search<Elements, F, Begin, End, 0> {
+			static void apply(std::size_t, F &) {}
 		};
+#endif // UTIL_APPLY_AT_VARIADIC
 
 	} // end of namespace detail
 
@@ -124,17 +188,27 @@ namespace util {
 	///
 	/// A template function that will call a user-provided functor
 	/// passing a single parameter, a boost::mpl::identity object parameterized
-	/// by the ith element of the given MPL sequence
+	/// by the ith element of the given sequence: either an MPL sequence or a
+	/// variadic type list like std::tuple<Ts...>.
+	///
+	/// The dispatch is a single lookup in a table generated at compile time.
+	/// Without C++11 (if UTIL_APPLY_AT_VARIADIC is not defined), only MPL
+	/// sequences are accepted and the dispatch is a binary search.
+	///
+	/// @returns false (without calling the functor) if i is out of range.
 	template<typename Sequence, typename F>
-	inline void apply_at(typename boost::uint_value_t<boost::mpl::size<Sequence>::type::value>::least i, F operation) {
-		typedef typename boost::mpl::size<Sequence>::type sequence_length;
-		typedef typename boost::uint_value_t<sequence_length::value>::least index_type;
-		typedef detail::apply_at_functor_impl<F, Sequence> functor_wrapper;
-		typedef detail::runtime_int_to_type_impl<index_type, sequence_length, functor_wrapper &> int_to_type;
-
-		functor_wrapper wrappedOp(operation);
-
-		int_to_type::apply(i, wrappedOp);
+	inline bool apply_at(std::size_t i, F operation) {
+#ifdef UTIL_APPLY_AT_VARIADIC
+		typedef detail::sequence_elements<Sequence> elements;
+		return detail::apply_at_impl<elements>(i, operation, make_index_sequence<elements::size>());
+#else
+		typedef detail::mpl_sequence_elements<Sequence> elements;
+		if (i >= elements::size) {
+			return false;
+		}
+		detail::apply_at_search<elements, F, 0, elements::size>::apply(i, operation);
+		return true;
+#endif
 	}
 	/// @}
 } // end of namespace util
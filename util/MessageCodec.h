@@ -0,0 +1,401 @@
+/** @file
+	@brief Header providing a generic, type-indexed encoder/decoder for
+	messages whose wire tag is their position in a type sequence.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_MessageCodec_h_GUID_861b1137_3c45_4207_8754_d0625499c458
+#define INCLUDED_MessageCodec_h_GUID_861b1137_3c45_4207_8754_d0625499c458
+
+// Internal Includes
+#include <util/IndexSequence.h>
+#include <util/MPLApplyAt.h>
+#include <util/MPLFindIndex.h>
+#include <util/ReceiveBuffer.h>
+
+// Library/third-party includes
+#include <boost/mpl/identity.hpp>
+
+// Standard includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace util {
+	/// @addtogroup DataStructures
+	/// @{
+
+	/// @brief Describes the wire format of the payload of one message type:
+	/// a fixed number of bytes, and how to write and read them.
+	///
+	/// The default copies the object representation (in host byte order),
+	/// which suits trivially-copyable structs. Specialize it for any other
+	/// message type, providing the same three members.
+	template<typename Message>
+	struct MessageWireFormat {
+		static_assert(std::is_trivially_copyable<Message>::value,
+		              "Specialize util::MessageWireFormat for message types that are not trivially copyable");
+
+		static const std::size_t size = sizeof(Message);
+
+		static void write(Message const& msg, unsigned char * out) {
+			std::memcpy(out, &msg, sizeof(Message));
+		}
+
+		static void read(unsigned char const* in, Message & msg) {
+			std::memcpy(&msg, in, sizeof(Message));
+		}
+	};
+
+	/// @brief Outcome of attempting to decode one message.
+	enum MessageDecodeResult {
+		/// A message was decoded into the storage.
+		MessageDecoded,
+		/// Not enough bytes for the tag or the payload it names: nothing was
+		/// consumed.
+		MessageIncomplete,
+		/// The tag does not name a type in the sequence: nothing was consumed.
+		MessageUnknownTag
+	};
+
+	/// @internal
+	namespace detail {
+		/// @brief constexpr maximum of a list of sizes.
+		///
+		/// @internal
+		constexpr std::size_t messageMaxOf(std::size_t a) {
+			return a;
+		}
+
+		template<typename... Rest>
+		constexpr std::size_t messageMaxOf(std::size_t a, std::size_t b, Rest... rest) {
+			return messageMaxOf(a < b ? b : a, rest...);
+		}
+
+		/// @brief Size and alignment needed to hold any element of a type
+		/// sequence, and the largest payload of any of them.
+		///
+		/// @internal
+		template<typename Elements, typename Indices = make_index_sequence<Elements::size> >
+		struct MessageStorageLayout;
+
+		template<typename Elements, std::size_t... Is>
+		struct MessageStorageLayout<Elements, index_sequence<Is...> > {
+			static const std::size_t size = messageMaxOf(1, sizeof(typename Elements::template at<Is>::type)...);
+			static const std::size_t alignment = messageMaxOf(1, alignof(typename Elements::template at<Is>::type)...);
+			static const std::size_t max_payload = messageMaxOf(0, MessageWireFormat<typename Elements::template at<Is>::type>::size...);
+		};
+
+		/// @brief apply_at functor destroying the message at an address.
+		///
+		/// @internal
+		struct MessageDestroyOp {
+			void * address;
+
+			template<typename M>
+			void operator()(boost::mpl::identity<M> const&) {
+				static_cast<M *>(address)->~M();
+			}
+		};
+
+		/// @brief apply_at functor calling a visitor with the message held
+		/// by a storage object.
+		///
+		/// @internal
+		template<typename Storage, typename F>
+		struct MessageVisitOp {
+			Storage & storage;
+			F & f;
+
+			template<typename M>
+			void operator()(boost::mpl::identity<M> const&) {
+				f(*storage.template get<M>());
+			}
+		};
+
+		/// @brief apply_at functor decoding a payload in place, if enough
+		/// bytes are available.
+		///
+		/// @internal
+		template<typename Storage>
+		struct MessageDecodeOp {
+			Storage & storage;
+			unsigned char const* payload;
+			std::size_t available;
+			std::size_t & needed;
+			bool & decoded;
+
+			template<typename M>
+			void operator()(boost::mpl::identity<M> const&) {
+				typedef MessageWireFormat<M> Format;
+				needed = Format::size;
+				if (available < Format::size) {
+					return;
+				}
+				Format::read(payload, storage.template emplace<M>());
+				decoded = true;
+			}
+		};
+	} // end of namespace detail
+
+	/// @brief Variant-like, fixed-size storage for one message from an MPL
+	/// sequence of message types.
+	///
+	/// Messages are constructed in place in an aligned buffer large enough
+	/// for any of them, so decoding never touches the heap.
+	template<typename Messages>
+	class MessageStorage {
+			typedef detail::sequence_elements<Messages> elements;
+			typedef detail::MessageStorageLayout<elements> layout;
+		public:
+			/// @brief Number of message types.
+			static const std::size_t count = elements::size;
+
+			MessageStorage() : _index(count) {}
+
+			~MessageStorage() {
+				reset();
+			}
+
+			MessageStorage(MessageStorage const&) = delete;
+			MessageStorage & operator=(MessageStorage const&) = delete;
+
+			/// @brief Whether no message is held.
+			bool empty() const {
+				return _index == count;
+			}
+
+			/// @brief Index in the sequence of the message held, or count if
+			/// empty.
+			std::size_t index() const {
+				return _index;
+			}
+
+			/// @brief Whether a message of type M is held.
+			template<typename M>
+			bool holds() const {
+				return _index == std::size_t(find_index<Messages, M>::value);
+			}
+
+			/// @brief Pointer to the held message if it is of type M, otherwise
+			/// null.
+			template<typename M>
+			M * get() {
+				return holds<M>() ? static_cast<M *>(address()) : nullptr;
+			}
+
+			/// @overload
+			template<typename M>
+			M const* get() const {
+				return holds<M>() ? static_cast<M const*>(address()) : nullptr;
+			}
+
+			/// @brief Destroys any held message, then constructs an M in place
+			/// from the given arguments.
+			template<typename M, typename... Args>
+			M & emplace(Args &&... args) {
+				reset();
+				M * msg = ::new(address()) M(std::forward<Args>(args)...);
+				_index = find_index<Messages, M>::value;
+				return *msg;
+			}
+
+			/// @brief Destroys any held message.
+			void reset() {
+				if (!empty()) {
+					detail::MessageDestroyOp op = {address()};
+					apply_at<Messages>(_index, op);
+					_index = count;
+				}
+			}
+
+			/// @brief Calls f with the held message, as its own type.
+			///
+			/// @returns false (without calling f) if empty.
+			template<typename F>
+			bool visit(F f) {
+				detail::MessageVisitOp<MessageStorage, F> op = {*this, f};
+				return apply_at<Messages>(_index, op);
+			}
+
+			/// @overload
+			template<typename F>
+			bool visit(F f) const {
+				detail::MessageVisitOp<MessageStorage const, F> op = {*this, f};
+				return apply_at<Messages>(_index, op);
+			}
+
+		private:
+			void * address() {
+				return &_data;
+			}
+			void const* address() const {
+				return &_data;
+			}
+
+			typename std::aligned_storage<layout::size, layout::alignment>::type _data;
+			std::size_t _index;
+	};
+
+	template<typename Messages>
+	const std::size_t MessageStorage<Messages>::count;
+
+	/// @brief Encoder/decoder for a protocol whose messages are the types in
+	/// an MPL sequence.
+	///
+	/// On the wire, each message is its tag - the index of its type in the
+	/// sequence, found at compile time with find_index, written as a
+	/// little-endian Tag - followed by the payload described by
+	/// MessageWireFormat. Decoding reads the tag, dispatches on it with
+	/// apply_at, and decodes in place into a MessageStorage.
+	///
+	/// A protocol is then a single declaration, such as
+	/// `typedef util::MessageCodec<boost::mpl::vector<Ping, Pose> > Protocol;`
+	template<typename Messages, typename Tag = std::uint8_t>
+	class MessageCodec {
+			static_assert(std::is_integral<Tag>::value && std::is_unsigned<Tag>::value,
+			              "Message tags must be an unsigned integer type");
+		public:
+			typedef Messages message_types;
+			typedef Tag tag_type;
+			typedef MessageStorage<Messages> storage_type;
+
+			/// @brief Number of message types.
+			static const std::size_t count = storage_type::count;
+
+			static_assert(count == 0 || count - 1 <= std::uintmax_t(std::numeric_limits<Tag>::max()),
+			              "Too many message types for the tag type");
+
+			/// @brief Number of bytes in an encoded tag.
+			static const std::size_t tag_size = sizeof(Tag);
+
+			/// @brief Size of the largest encoded message.
+			static const std::size_t max_encoded_size = tag_size + detail::MessageStorageLayout<detail::sequence_elements<Messages> >::max_payload;
+
+			/// @brief Metafunction giving the tag of message type M.
+			template<typename M>
+			struct tag_of : find_index<Messages, M> {};
+
+			/// @brief Size of an encoded message of type M.
+			template<typename M>
+			static constexpr std::size_t encodedSize() {
+				return tag_size + MessageWireFormat<M>::size;
+			}
+
+			/// @brief Writes the tag and payload of msg to an output iterator
+			/// over bytes.
+			///
+			/// @returns the output iterator past the last byte written.
+			template<typename M, typename OutputIterator>
+			static OutputIterator encode(M const& msg, OutputIterator out) {
+				unsigned char bytes[encodedSize<M>()];
+				writeTag(tag_of<M>::value, bytes);
+				MessageWireFormat<M>::write(msg, bytes + tag_size);
+				return std::copy(bytes, bytes + sizeof(bytes), out);
+			}
+
+			/// @brief Decodes one message from the start of a byte range into
+			/// out.
+			///
+			/// @param consumed Set to the number of bytes making up the
+			/// message if it was decoded, otherwise 0.
+			static MessageDecodeResult decode(unsigned char const* data, std::size_t len, storage_type & out, std::size_t & consumed) {
+				consumed = 0;
+				if (len < tag_size) {
+					return MessageIncomplete;
+				}
+				const std::size_t tag = readTag(data);
+				if (tag >= count) {
+					return MessageUnknownTag;
+				}
+				std::size_t needed = 0;
+				bool decoded = false;
+				detail::MessageDecodeOp<storage_type> op = {out, data + tag_size, len - tag_size, needed, decoded};
+				apply_at<Messages>(tag, op);
+				if (!decoded) {
+					return MessageIncomplete;
+				}
+				consumed = tag_size + needed;
+				return MessageDecoded;
+			}
+
+			/// @brief Decodes one message from the front of a receive buffer
+			/// into out, removing its bytes from the buffer if successful.
+			template<std::size_t N, typename V>
+			static MessageDecodeResult decode(ReceiveBuffer<N, V> & buf, storage_type & out) {
+				static_assert(sizeof(V) == 1, "Messages can only be decoded from a buffer of bytes");
+				if (buf.empty()) {
+					return MessageIncomplete;
+				}
+				std::size_t consumed = 0;
+				MessageDecodeResult result = decode(reinterpret_cast<unsigned char const*>(buf.data()), buf.size(), out, consumed);
+				if (result == MessageDecoded) {
+					buf.pop_front(consumed);
+				}
+				return result;
+			}
+
+			/// @brief Decodes every complete message at the front of a receive
+			/// buffer, calling handler with each one as its own type.
+			///
+			/// @returns MessageIncomplete once the buffer holds no further
+			/// complete message, or MessageUnknownTag if it stopped at a tag
+			/// it does not recognize (left at the front of the buffer).
+			template<std::size_t N, typename V, typename F>
+			static MessageDecodeResult dispatch(ReceiveBuffer<N, V> & buf, storage_type & out, F handler) {
+				MessageDecodeResult result;
+				while ((result = decode(buf, out)) == MessageDecoded) {
+					out.visit(std::ref(handler));
+				}
+				return result;
+			}
+
+		private:
+			static void writeTag(std::size_t tag, unsigned char * out) {
+				for (std::size_t i = 0; i < tag_size; ++i) {
+					out[i] = static_cast<unsigned char>((std::uintmax_t(tag) >> (8 * i)) & 0xff);
+				}
+			}
+
+			static std::size_t readTag(unsigned char const* in) {
+				std::uintmax_t tag = 0;
+				for (std::size_t i = 0; i < tag_size; ++i) {
+					tag |= std::uintmax_t(in[i]) << (8 * i);
+				}
+				return tag < count ? std::size_t(tag) : count;
+			}
+	};
+
+	template<typename Messages, typename Tag>
+	const std::size_t MessageCodec<Messages, Tag>::count;
+
+	template<typename Messages, typename Tag>
+	const std::size_t MessageCodec<Messages, Tag>::tag_size;
+
+	template<typename Messages, typename Tag>
+	const std::size_t MessageCodec<Messages, Tag>::max_encoded_size;
+
+	/// @}
+} // end of namespace util
+
+#endif // INCLUDED_MessageCodec_h_GUID_861b1137_3c45_4207_8754_d0625499c458
@@ -26,11 +26,18 @@
 // - none
 
 // Library/third-party includes
-// - none
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTIL_RANGEDINT_HAVE_SSE2
+#endif
 
 // Standard includes
 #include <stdexcept>
 #include <cassert>
+#include <cstddef>
 
 
 namespace util {
@@ -58,6 +65,19 @@ namespace util {
 		static void aboveMax(int) {
 			throw std::out_of_range("Above maximum value for a ranged int!");
 		}
+
+		/// @name Run-time bounds, used by DynamicRangedInt
+		/// @{
+		template<typename T>
+		static void belowMinimum(T, T) {
+			throw std::out_of_range("Below minimum value for a ranged int!");
+		}
+
+		template<typename T>
+		static void aboveMaximum(T, T) {
+			throw std::out_of_range("Above maximum value for a ranged int!");
+		}
+		/// @}
 	};
 
 	struct AssertOutOfRange {
@@ -69,12 +89,81 @@ namespace util {
 		static void aboveMax(int val) {
 			assert(val <= MaxVal);
 		}
+
+		/// @name Run-time bounds, used by DynamicRangedInt
+		/// @{
+		template<typename T>
+		static void belowMinimum(T val, T minVal) {
+			assert(val >= minVal);
+			(void)val;
+			(void)minVal;
+		}
+		template<typename T>
+		static void aboveMaximum(T val, T maxVal) {
+			assert(val <= maxVal);
+			(void)val;
+			(void)maxVal;
+		}
+		/// @}
 	};
 
 	template<int MinVal, int MaxVal, typename CheckingPolicy, typename ErrorPolicy>
 	class RangedInt;
 
+	/// Tag type for constructing a RangedInt from a value already known to
+	/// be in range (for instance, from a span checked by findOutOfRange()),
+	/// skipping the check.
+	struct RangePrevalidated {};
+
 	namespace detail {
+		/// @brief Range check with a single comparison, for any integer type:
+		/// subtracting minVal as unsigned makes values below minVal wrap
+		/// around to values above maxVal - minVal.
+		template<typename T>
+		inline bool isOutOfRange(T val, T minVal, T maxVal) {
+			typedef typename boost::make_unsigned<T>::type U;
+			return static_cast<U>(static_cast<U>(val) - static_cast<U>(minVal))
+			       > static_cast<U>(static_cast<U>(maxVal) - static_cast<U>(minVal));
+		}
+
+		template<int MinVal, int MaxVal>
+		inline bool isOutOfRange(int val) {
+			return isOutOfRange<int>(val, MinVal, MaxVal);
+		}
+
+		/// @brief Index of the first value of data[0, n) outside [minVal,
+		/// maxVal], or n if there is none.
+		inline std::size_t findFirstOutOfRange(const int * data, std::size_t n, int minVal, int maxVal) {
+			const unsigned int offset = static_cast<unsigned int>(minVal);
+			const unsigned int span = static_cast<unsigned int>(maxVal) - offset;
+			std::size_t i = 0;
+#ifdef UTIL_RANGEDINT_HAVE_SSE2
+			// SSE2 has no unsigned compare, so flip the sign bits and compare signed.
+			const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+			const __m128i offset4 = _mm_set1_epi32(static_cast<int>(offset));
+			const __m128i limit4 = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(span)), bias);
+			// Blocks of 16: OR the lane masks together and test once per block,
+			// falling through to the scalar loop to locate the first violation.
+			for (; i + 16 <= n; i += 16) {
+				__m128i bad = _mm_setzero_si128();
+				for (std::size_t j = 0; j < 16; j += 4) {
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + j));
+					v = _mm_xor_si128(_mm_sub_epi32(v, offset4), bias);
+					bad = _mm_or_si128(bad, _mm_cmpgt_epi32(v, limit4));
+				}
+				if (_mm_movemask_epi8(bad) != 0) {
+					break;
+				}
+			}
+#endif
+			for (; i < n; ++i) {
+				if (static_cast<unsigned int>(data[i]) - offset > span) {
+					return i;
+				}
+			}
+			return n;
+		}
+
 		struct NullCheck {
 			static void check(int) {}
 		};
@@ -107,10 +196,37 @@ namespace util {
 		template<bool actuallyCheck, int MinVal, int MaxVal, typename ErrorPolicy>
 		struct DoRangeCheck {
 			static void check(int val) {
-				CheckMin<actuallyCheck, MinVal, ErrorPolicy>::check(val);
-				CheckMax<actuallyCheck, MaxVal, ErrorPolicy>::check(val);
+				// One well-predicted branch in the common case: only work
+				// out which bound was violated once we know one was.
+				if (isOutOfRange<MinVal, MaxVal>(val)) {
+					CheckMin<actuallyCheck, MinVal, ErrorPolicy>::check(val);
+					CheckMax<actuallyCheck, MaxVal, ErrorPolicy>::check(val);
+				}
 			}
 		};
+
+		template<int MinVal, int MaxVal, typename ErrorPolicy>
+		struct DoRangeCheck<false, MinVal, MaxVal, ErrorPolicy> : NullCheck { };
+
+		template<bool actuallyCheck, typename ErrorPolicy>
+		struct DoDynamicRangeCheck {
+			template<typename T>
+			static void check(T val, T minVal, T maxVal) {
+				if (isOutOfRange(val, minVal, maxVal)) {
+					if (val < minVal) {
+						ErrorPolicy::belowMinimum(val, minVal);
+					} else {
+						ErrorPolicy::aboveMaximum(val, maxVal);
+					}
+				}
+			}
+		};
+
+		template<typename ErrorPolicy>
+		struct DoDynamicRangeCheck<false, ErrorPolicy> {
+			template<typename T>
+			static void check(T, T, T) {}
+		};
 	} // end of namespace detail
 
 /// @addtogroup DataStructures Data Structures
@@ -118,9 +234,11 @@ namespace util {
 
 	/// A lightweight container template for integer values from a compile-time-defined range,
 	/// with range checking and error handling as policy classes.
-	/// @todo static assert that minVal <= maxVal
+	///
+	/// A RangedInt is exactly the size of an int.
 	template<int MinVal, int MaxVal, typename CheckingPolicy = AlwaysCheck, typename ErrorPolicy = ThrowOutOfRange>
 	class RangedInt {
+			BOOST_STATIC_ASSERT(MinVal <= MaxVal);
 		public:
 			static const bool checked = CheckingPolicy::checked;
 			static const int min_val = MinVal;
@@ -150,6 +268,11 @@ namespace util {
 				_rangeCheck();
 			}
 
+			/// Construct from a value known to be in range, without checking.
+			RangedInt(int v, RangePrevalidated)
+				: value(v) {
+			}
+
 			RangedInt(self_type const& other)
 				: value(other.value) {
 				/* known ok, copy from same type */
@@ -181,6 +304,136 @@ namespace util {
 			}
 	};
 
+	/// Returns a pointer to the first value in [begin, end) outside
+	/// [MinVal, MaxVal], or end if all are in range. Vectorized where SSE2
+	/// is available.
+	template<int MinVal, int MaxVal>
+	inline const int * findOutOfRange(const int * begin, const int * end) {
+		BOOST_STATIC_ASSERT(MinVal <= MaxVal);
+		return begin + detail::findFirstOutOfRange(begin, static_cast<std::size_t>(end - begin), MinVal, MaxVal);
+	}
+
+	/// Returns a pointer to the first value in [begin, end) outside
+	/// [minVal, maxVal], or end if all are in range.
+	inline const int * findOutOfRange(const int * begin, const int * end, int minVal, int maxVal) {
+		assert(minVal <= maxVal);
+		return begin + detail::findFirstOutOfRange(begin, static_cast<std::size_t>(end - begin), minVal, maxVal);
+	}
+
+	/// A counterpart to RangedInt for ranges only known at run time, like
+	/// buffer lengths: an integer of type T (any signed or unsigned integer
+	/// type, including 64-bit ones) with inclusive bounds stored alongside
+	/// it, and the same checking and error policies.
+	///
+	/// Each check is a single unsigned comparison, and checks compile out
+	/// entirely with NeverCheck (or CheckInDebug in release builds).
+	template<typename T, typename CheckingPolicy = AlwaysCheck, typename ErrorPolicy = ThrowOutOfRange>
+	class DynamicRangedInt {
+		public:
+			typedef T value_type;
+			static const bool checked = CheckingPolicy::checked;
+
+			typedef DynamicRangedInt<T, CheckingPolicy, ErrorPolicy> self_type;
+
+		private:
+			T value;
+			T minVal;
+			T maxVal;
+			void _rangeCheck() const {
+				detail::DoDynamicRangeCheck<checked, ErrorPolicy>::check(value, minVal, maxVal);
+			}
+
+		public:
+			DynamicRangedInt(T v, T minimum, T maximum)
+				: value(v)
+				, minVal(minimum)
+				, maxVal(maximum) {
+				assert(minimum <= maximum);
+				_rangeCheck();
+			}
+
+			/// Construct from a value known to be in range, without checking.
+			DynamicRangedInt(T v, T minimum, T maximum, RangePrevalidated)
+				: value(v)
+				, minVal(minimum)
+				, maxVal(maximum) {
+				assert(minimum <= maximum);
+			}
+
+			operator T() const {
+				return value;
+			}
+
+			/// Assigns a new value, checked against the existing bounds.
+			self_type & operator=(T v) {
+				value = v;
+				_rangeCheck();
+				return *this;
+			}
+
+			T minimum() const {
+				return minVal;
+			}
+
+			T maximum() const {
+				return maxVal;
+			}
+	};
+
+	/// A view of an array of plain ints, range checked once on construction
+	/// (according to the policies, reporting the first out-of-range value)
+	/// and accessed afterwards as RangedInt values without further checks.
+	///
+	/// This lets index buffers and the like be stored and loaded as plain
+	/// ints and validated in bulk, instead of checking each access.
+	template<int MinVal, int MaxVal, typename CheckingPolicy = AlwaysCheck, typename ErrorPolicy = ThrowOutOfRange>
+	class RangedIntSpan {
+		public:
+			typedef RangedInt<MinVal, MaxVal, CheckingPolicy, ErrorPolicy> value_type;
+			typedef std::size_t size_type;
+
+			RangedIntSpan(const int * data, size_type n)
+				: _data(data)
+				, _size(n) {
+				if (CheckingPolicy::checked) {
+					size_type bad = detail::findFirstOutOfRange(data, n, MinVal, MaxVal);
+					if (bad != n) {
+						// Reports the failure through the error policy.
+						value_type checked(data[bad]);
+						(void)checked;
+					}
+				}
+			}
+
+			value_type operator[](size_type i) const {
+				return value_type(_data[i], RangePrevalidated());
+			}
+
+			/// Bounds-checked element access
+			value_type at(size_type i) const {
+				if (i >= _size) {
+					throw std::out_of_range("Index out of range for RangedIntSpan!");
+				}
+				return (*this)[i];
+			}
+
+			size_type size() const {
+				return _size;
+			}
+
+			bool empty() const {
+				return _size == 0;
+			}
+
+			const int * data() const {
+				return _data;
+			}
+
+		private:
+			const int * _data;
+			size_type _size;
+	};
+
 
 } // end of namespace util
 
@@ -28,18 +28,282 @@
 
 // Library includes
 #include <Eigen/Core>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define UTIL_SATURATE_HAVE_SSE
+#endif
 
 // Standard includes
-// - none
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
 
 namespace util {
 
+	namespace detail {
+		/// @internal
+		/// @brief 1 / sqrt(x)
+		template<typename Scalar>
+		inline Scalar reciprocalSqrt(Scalar const x) {
+			using std::sqrt;
+			return Scalar(1) / sqrt(x);
+		}
+
+#ifdef UTIL_SATURATE_HAVE_SSE
+		/// @internal
+		/// @brief 1 / sqrt(x) for float, from the hardware estimate refined
+		/// with one Newton-Raphson step (relative error around 1e-7).
+		/// The estimate treats denormals as zero and gives 0 for infinity,
+		/// where the Newton step would produce NaN, so anything outside the
+		/// normal range takes the exact path.
+		template<>
+		inline float reciprocalSqrt(float const x) {
+			if (!(FLT_MIN <= x && x <= FLT_MAX)) {
+				return 1.0f / std::sqrt(x);
+			}
+			const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+			return y * (1.5f - 0.5f * x * y * y);
+		}
+#endif
+
+		/// @internal
+		/// @brief maxMagnitude / sqrt(squaredNorm), rounded once so double
+		/// results match maxMagnitude / vec.norm() exactly.
+		template<typename Scalar>
+		inline Scalar maxOverNorm(Scalar const maxMagnitude, Scalar const squaredNorm) {
+			using std::sqrt;
+			return maxMagnitude / sqrt(squaredNorm);
+		}
+
+#ifdef UTIL_SATURATE_HAVE_SSE
+		/// @internal
+		/// @brief maxMagnitude / sqrt(squaredNorm) for float, through
+		/// reciprocalSqrt() to avoid the divide.
+		template<>
+		inline float maxOverNorm(float const maxMagnitude, float const squaredNorm) {
+			return maxMagnitude * reciprocalSqrt(squaredNorm);
+		}
+#endif
+
+		/// @internal
+		/// @brief Runs Mode::scale() for vec, rescaling first if the squared
+		/// norm overflows: every mode depends only on |vec| / maxMagnitude,
+		/// so dividing both by the largest coefficient gives the same factor.
+		template<typename Mode, typename Derived>
+		inline bool saturationFactor(Eigen::MatrixBase<Derived> const& vec, typename Derived::Scalar const maxMagnitude,
+		                             typename Derived::Scalar & factor) {
+			typedef typename Derived::Scalar Scalar;
+			const Scalar squaredNorm = vec.squaredNorm();
+			if (squaredNorm > Eigen::NumTraits<Scalar>::highest()) {
+				const Scalar largest = vec.cwiseAbs().maxCoeff();
+				if (largest <= Eigen::NumTraits<Scalar>::highest()) {
+					return Mode::scale((vec / largest).squaredNorm(), maxMagnitude / largest, factor);
+				}
+			}
+			return Mode::scale(squaredNorm, maxMagnitude, factor);
+		}
+
+		/// @internal
+		/// @brief Number of vectors handled per step by the batch saturate
+		/// functions, so their temporaries can live on the stack.
+		enum {
+			SATURATE_BATCH_SIZE = 128
+		};
+
+		/// @internal
+		template<typename Scalar>
+		struct SaturateBatch {
+			typedef Eigen::Array<Scalar, 1, Eigen::Dynamic, Eigen::RowMajor, 1, SATURATE_BATCH_SIZE> RowArray;
+		};
+
+		/// @internal
+		/// @brief Replaces squared norms with norms, calling
+		/// stableNorm(i) for the (rare) ones that overflowed. Eigen's
+		/// vectorized float sqrt may give NaN rather than infinity for
+		/// those, so anything not finite is recomputed.
+		template<typename Scalar, typename StableNorm>
+		inline void squaredNormsToNorms(typename SaturateBatch<Scalar>::RowArray & norms, StableNorm stableNorm) {
+			norms = norms.sqrt();
+			if (!(norms <= Eigen::NumTraits<Scalar>::highest()).all()) {
+				for (Eigen::DenseIndex i = 0; i < norms.size(); ++i) {
+					if (!(norms[i] <= Eigen::NumTraits<Scalar>::highest())) {
+						norms[i] = stableNorm(i);
+					}
+				}
+			}
+		}
+
+		/// @internal
+		/// @brief Replaces norms with the factor to scale each vector by
+		/// (exactly 1 for those not saturated), writes the saturation mask
+		/// if requested, and returns the number saturated.
+		template<typename Scalar>
+		inline std::size_t normsToSaturationScales(typename SaturateBatch<Scalar>::RowArray & scales,
+		        Scalar const maxMagnitude, bool * saturatedMask) {
+			typedef typename SaturateBatch<Scalar>::RowArray RowArray;
+			if (saturatedMask) {
+				for (Eigen::DenseIndex i = 0; i < scales.size(); ++i) {
+					saturatedMask[i] = scales[i] > maxMagnitude;
+				}
+			}
+			std::size_t count = (scales > maxMagnitude).count();
+			scales = (scales > maxMagnitude).select(RowArray::Constant(scales.size(), maxMagnitude) / scales, Scalar(1));
+			return count;
+		}
+
+		/// @internal
+		/// @brief Stable norm of column i of a batch starting at column
+		/// start, for squaredNormsToNorms().
+		template<typename Derived>
+		struct ColumnStableNorm {
+			ColumnStableNorm(Eigen::MatrixBase<Derived> const& columns, Eigen::DenseIndex start) : _columns(columns), _start(start) {}
+			typename Derived::Scalar operator()(Eigen::DenseIndex i) const {
+				return _columns.col(_start + i).stableNorm();
+			}
+			Eigen::MatrixBase<Derived> const& _columns;
+			Eigen::DenseIndex _start;
+		};
+
+		/// @internal
+		/// @brief Stable norm of vector i of a structure-of-arrays batch, for
+		/// squaredNormsToNorms().
+		template<typename RowMap>
+		struct SoAStableNorm {
+			typedef typename RowMap::Scalar Scalar;
+			SoAStableNorm(RowMap const& x, RowMap const& y, RowMap const& z) : _x(x), _y(y), _z(z) {}
+			Scalar operator()(Eigen::DenseIndex i) const {
+				return Eigen::Matrix<Scalar, 3, 1>(_x[i], _y[i], _z[i]).stableNorm();
+			}
+			RowMap const& _x;
+			RowMap const& _y;
+			RowMap const& _z;
+		};
+
+		/// @internal
+		/// @brief saturateArray() implementation for spans of fixed-size
+		/// vectors, which are contiguous.
+		template<typename VecType, bool IsDynamic = (VecType::RowsAtCompileTime == Eigen::Dynamic)>
+		struct SaturateArrayImpl {
+			typedef typename VecType::Scalar Scalar;
+			typedef Eigen::Matrix<Scalar, VecType::RowsAtCompileTime, Eigen::Dynamic> ColumnsType;
+			static std::size_t apply(VecType * vectors, std::size_t n, Scalar const maxMagnitude, bool * saturatedMask);
+		};
+
+		/// @internal
+		/// @brief saturateArray() implementation for spans of dynamic-size
+		/// vectors, each of which is stored separately.
+		template<typename VecType>
+		struct SaturateArrayImpl<VecType, true> {
+			typedef typename VecType::Scalar Scalar;
+			typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> ColumnType;
+			static std::size_t apply(VecType * vectors, std::size_t n, Scalar const maxMagnitude, bool * saturatedMask);
+		};
+	} // end of namespace detail
+
 /// @addtogroup Math Math Utilities
 /// @{
 
+	/// @brief Hard saturation: vectors longer than the max magnitude are
+	/// scaled down to exactly the max magnitude, and others are unchanged.
+	struct HardSaturation {
+		template<typename Scalar>
+		static bool scale(Scalar const squaredNorm, Scalar const maxMagnitude, Scalar & factor) {
+			if (squaredNorm > maxMagnitude * maxMagnitude) {
+				factor = detail::maxOverNorm(maxMagnitude, squaredNorm);
+				return true;
+			}
+			return false;
+		}
+	};
+
+	/// @brief Soft saturation with tanh: the magnitude becomes
+	/// maxMagnitude * tanh(|vec| / maxMagnitude), so it approaches the max
+	/// magnitude smoothly, but every nonzero vector is reduced somewhat.
+	struct TanhSaturation {
+		template<typename Scalar>
+		static bool scale(Scalar const squaredNorm, Scalar const maxMagnitude, Scalar & factor) {
+			using std::tanh;
+			if (squaredNorm == 0) {
+				return false;
+			}
+			if (!(maxMagnitude > 0)) {
+				factor = 0;
+				return true;
+			}
+			const Scalar ratio = squaredNorm * detail::reciprocalSqrt(squaredNorm) / maxMagnitude;
+			factor = tanh(ratio) / ratio;
+			return factor < 1;
+		}
+	};
+
+	/// @brief Soft saturation with a cubic knee: with r = |vec| /
+	/// maxMagnitude, the magnitude becomes maxMagnitude * (r - 4/27 r^3) up to
+	/// r = 1.5, where it meets maxMagnitude with zero slope, and
+	/// maxMagnitude beyond that. Cheaper than tanh: below the knee no square
+	/// root is needed.
+	struct CubicKneeSaturation {
+		template<typename Scalar>
+		static bool scale(Scalar const squaredNorm, Scalar const maxMagnitude, Scalar & factor) {
+			if (squaredNorm == 0) {
+				return false;
+			}
+			if (!(maxMagnitude > 0)) {
+				factor = 0;
+				return true;
+			}
+			const Scalar squaredRatio = squaredNorm / (maxMagnitude * maxMagnitude);
+			if (squaredRatio >= Scalar(2.25)) {
+				factor = detail::maxOverNorm(maxMagnitude, squaredNorm);
+			} else {
+				factor = Scalar(1) - Scalar(4) / Scalar(27) * squaredRatio;
+			}
+			return factor < 1;
+		}
+	};
+
+	/** Saturate the vector at the given max magnitude, using the given mode
+		(HardSaturation, TanhSaturation or CubicKneeSaturation).
+
+		@param vec The input and output vector: any writable Eigen vector
+		expression.
+		@param maxMagnitude the maximum magnitude @paramref vec is permitted to have
+
+		@returns true if the magnitude of vec was reduced.
+	*/
+	template<typename Mode, typename Derived>
+	inline bool saturateUsing(Eigen::MatrixBase<Derived> const& vec, typename Derived::Scalar const maxMagnitude) {
+		typename Derived::Scalar factor;
+		if (detail::saturationFactor<Mode>(vec, maxMagnitude, factor)) {
+			// Eigen idiom for writing to temporary expressions.
+			const_cast<Eigen::MatrixBase<Derived> &>(vec) *= factor;
+			return true;
+		}
+		return false;
+	}
+
+	/** Saturate the vector at the given max magnitude, using the given mode
+		(HardSaturation, TanhSaturation or CubicKneeSaturation), scaling
+		otherVec in proportion.
+
+		@returns true if the magnitude of vec was reduced.
+	*/
+	template<typename Mode, typename Derived, typename OtherDerived>
+	inline bool saturateUsing(Eigen::MatrixBase<Derived> const& vec, typename Derived::Scalar const maxMagnitude,
+	                          Eigen::MatrixBase<OtherDerived> const& otherVec) {
+		typename Derived::Scalar factor;
+		if (detail::saturationFactor<Mode>(vec, maxMagnitude, factor)) {
+			const_cast<Eigen::MatrixBase<Derived> &>(vec) *= factor;
+			const_cast<Eigen::MatrixBase<OtherDerived> &>(otherVec) *= factor;
+			return true;
+		}
+		return false;
+	}
+
 	/** Saturate the vector at the given max magnitude.
 
-		@param vec The input and output vector
+		@param vec The input and output vector: any writable Eigen vector
+		expression, fixed or dynamic size.
 		@param maxMagnitude the maximum magnitude @paramref vec is permitted to have
 
 		@returns true if this vector was saturated.
@@ -47,18 +311,15 @@ namespace util {
 		vec stays the same if it has magnitude < maxMagnitude, otherwise
 		it returns a vector of magnitude maxMagnitude in the direction of vec
 	*/
-	inline bool saturate(Eigen::Vector3d & vec, double const maxMagnitude) {
-		if (vec.squaredNorm() > maxMagnitude * maxMagnitude) {
-			const double reduction = (maxMagnitude / vec.norm());
-			vec *= reduction;
-			return true;
-		}
-		return false;
+	template<typename Derived>
+	inline bool saturate(Eigen::MatrixBase<Derived> const& vec, typename Derived::Scalar const maxMagnitude) {
+		return saturateUsing<HardSaturation>(vec, maxMagnitude);
 	}
 
 	/** Saturate the vector at the given max magnitude.
 
-		@param vec The input and output vector
+		@param vec The input and output vector: any writable Eigen vector
+		expression, fixed or dynamic size.
 		@param maxMagnitude the maximum magnitude @paramref vec is permitted to have
 		@param otherVec the paired vector which will be scaled in proportion to @paramref vec's scaling
 
@@ -69,16 +330,124 @@ namespace util {
 		If vec is scaled down to not exceed maxMagnitude, scale down otherVec
 		by the same proportion.
 	*/
-	inline bool saturate(Eigen::Vector3d & vec, double const maxMagnitude, Eigen::Vector3d & otherVec) {
-		if (vec.squaredNorm() > maxMagnitude * maxMagnitude) {
-			const double reduction = (maxMagnitude / vec.norm());
-			vec *= reduction;
-			otherVec *= reduction;
-			return true;
+	template<typename Derived, typename OtherDerived>
+	inline bool saturate(Eigen::MatrixBase<Derived> const& vec, typename Derived::Scalar const maxMagnitude,
+	                     Eigen::MatrixBase<OtherDerived> const& otherVec) {
+		return saturateUsing<HardSaturation>(vec, maxMagnitude, otherVec);
+	}
+
+	/** Saturate each column of a matrix at the given max magnitude.
+
+		@param vectors The input and output vectors, one per column: may be
+		any writable Eigen expression, such as a Map or block.
+		@param maxMagnitude the maximum magnitude (at least 0) each vector is
+		permitted to have
+		@param saturatedMask if not NULL, element i is set to whether
+		column i was saturated.
+
+		@returns the number of vectors saturated.
+
+		Scale factors for a batch of vectors are computed together with
+		array operations (no branch per vector), and vectors that are not
+		saturated are scaled by exactly 1.
+	*/
+	template<typename Derived>
+	inline std::size_t saturateColumns(Eigen::MatrixBase<Derived> const& vectors, typename Derived::Scalar const maxMagnitude,
+	                                   bool * saturatedMask = NULL) {
+		typedef typename Derived::Scalar Scalar;
+		typedef typename detail::SaturateBatch<Scalar>::RowArray RowArray;
+		// Eigen idiom for writing to temporary expressions.
+		Eigen::MatrixBase<Derived> & columns = const_cast<Eigen::MatrixBase<Derived> &>(vectors);
+		std::size_t count = 0;
+		const Eigen::DenseIndex n = columns.cols();
+		for (Eigen::DenseIndex start = 0; start < n; start += detail::SATURATE_BATCH_SIZE) {
+			const Eigen::DenseIndex len = (std::min)(Eigen::DenseIndex(detail::SATURATE_BATCH_SIZE), n - start);
+			RowArray scales = columns.middleCols(start, len).colwise().squaredNorm().array();
+			detail::squaredNormsToNorms<Scalar>(scales, detail::ColumnStableNorm<Derived>(columns, start));
+			count += detail::normsToSaturationScales(scales, maxMagnitude, saturatedMask ? saturatedMask + start : NULL);
+			columns.middleCols(start, len).array().rowwise() *= scales;
 		}
-		return false;
+		return count;
 	}
 
+	/** Saturate each of a contiguous array of vectors at the given max
+		magnitude.
+
+		@param vectors The input and output vectors: any Eigen column vector
+		type, such as Eigen::Vector3d, Eigen::Vector3f, Eigen::Vector4f or
+		Eigen::VectorXd.
+		@param n the number of vectors
+		@param maxMagnitude the maximum magnitude (at least 0) each vector is
+		permitted to have
+		@param saturatedMask if not NULL, element i is set to whether
+		vector i was saturated.
+
+		@returns the number of vectors saturated.
+
+		Fixed-size vectors are processed as the columns of one matrix: see
+		saturateColumns().
+	*/
+	template<typename VecType>
+	inline std::size_t saturateArray(VecType * vectors, std::size_t n, typename VecType::Scalar const maxMagnitude,
+	                                 bool * saturatedMask = NULL) {
+		return detail::SaturateArrayImpl<VecType>::apply(vectors, n, maxMagnitude, saturatedMask);
+	}
+
+	/** Saturate each of an array of 3D vectors, stored as separate x, y
+		and z arrays, at the given max magnitude.
+
+		@param saturatedMask if not NULL, element i is set to whether
+		vector i was saturated.
+
+		@returns the number of vectors saturated.
+
+		Every step is an array operation over contiguous data, so this is
+		the layout that makes the most of Eigen's SIMD packet math.
+	*/
+	template<typename Scalar>
+	inline std::size_t saturateArray(Scalar * x, Scalar * y, Scalar * z, std::size_t n, Scalar const maxMagnitude,
+	                                 bool * saturatedMask = NULL) {
+		typedef typename detail::SaturateBatch<Scalar>::RowArray RowArray;
+		typedef Eigen::Map<RowArray> RowMap;
+		std::size_t count = 0;
+		for (std::size_t start = 0; start < n; start += detail::SATURATE_BATCH_SIZE) {
+			const Eigen::DenseIndex len = static_cast<Eigen::DenseIndex>((std::min)(std::size_t(detail::SATURATE_BATCH_SIZE), n - start));
+			RowMap xs(x + start, len);
+			RowMap ys(y + start, len);
+			RowMap zs(z + start, len);
+			RowArray scales = xs.square() + ys.square() + zs.square();
+			detail::squaredNormsToNorms<Scalar>(scales, detail::SoAStableNorm<RowMap>(xs, ys, zs));
+			count += detail::normsToSaturationScales(scales, maxMagnitude, saturatedMask ? saturatedMask + start : NULL);
+			xs *= scales;
+			ys *= scales;
+			zs *= scales;
+		}
+		return count;
+	}
+
+	namespace detail {
+		template<typename VecType, bool IsDynamic>
+		inline std::size_t SaturateArrayImpl<VecType, IsDynamic>::apply(VecType * vectors, std::size_t n,
+		        Scalar const maxMagnitude, bool * saturatedMask) {
+			if (n == 0) {
+				return 0;
+			}
+			Eigen::Map<ColumnsType> columns(vectors->data(), VecType::RowsAtCompileTime, static_cast<Eigen::DenseIndex>(n));
+			return saturateColumns(columns, maxMagnitude, saturatedMask);
+		}
+
+		template<typename VecType>
+		inline std::size_t SaturateArrayImpl<VecType, true>::apply(VecType * vectors, std::size_t n,
+		        Scalar const maxMagnitude, bool * saturatedMask) {
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				Eigen::Map<ColumnType> column(vectors[i].data(), vectors[i].size());
+				count += saturateColumns(column, maxMagnitude, saturatedMask ? saturatedMask + i : NULL);
+			}
+			return count;
+		}
+	} // end of namespace detail
+
 /// @}
 
 }
@@ -27,10 +27,16 @@
 // - none
 
 // Library/third-party includes
-// - none
+#include <boost/functional/hash.hpp>
 
 // Standard includes
 #include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#ifndef BOOST_NO_CXX11_HDR_FUNCTIONAL
+#include <functional>
+#endif
 
 namespace util {
 
@@ -60,39 +66,33 @@ namespace util {
 			/// Contained value type
 			typedef T value_type;
 
-			/// Default constructor: requires T be default constructible and have
-			/// an assignment operator
-			Set2() {
-				if (_second < _first) {
-					std::swap(_first, _second);
-				}
-			}
+			/// Default constructor: value-initializes both elements, which are
+			/// then equal and so already in order.
+			Set2() : _first(), _second() {}
 
-			/// Constructor from values: requires T be copy constructible
+			/// Constructor from values: requires T be copy constructible.
+			/// Compares once (in C++11), so for arithmetic types the ordering
+			/// typically compiles to conditional moves rather than a branch.
+#ifndef BOOST_NO_CXX11_DELEGATING_CONSTRUCTORS
+			Set2(T const& a, T const& b) : Set2(a, b, b < a) {}
+#else
 			Set2(T const& a, T const& b) :
 				_first(b < a ? b : a),
 				_second(b < a ? a : b) {}
+#endif
 
-			/// Copy constructor
-			Set2(Set2<T> const& other) :
-				_first(other._first),
-				_second(other._second) {}
-
-			/// Assignment operator
-			Set2<T> const& operator=(Set2<T> const& other) {
-				if (&other == this) {
-					/// Shortcut self-assignment
-					return *this;
-				}
-				_first = other._first;
-				_second = other._second;
-				return *this;
-			}
+			// The copy constructor and assignment operator are implicit, so
+			// Set2 is trivially copyable when T is.
 
 			/// Mutator: must change both at once to enforce internal order
 			Set2<T> const& set(T const& a, T const& b) {
-				Set2<T> temp(a, b);
-				*this = temp;
+				// Copy first: a or b may refer to one of our own elements.
+				const bool swapped = b < a;
+				T lo(swapped ? b : a);
+				T hi(swapped ? a : b);
+				using std::swap;
+				swap(_first, lo);
+				swap(_second, hi);
 				return *this;
 			}
 
@@ -107,6 +107,13 @@ namespace util {
 			}
 
 		private:
+#ifndef BOOST_NO_CXX11_DELEGATING_CONSTRUCTORS
+			/// Constructor given the result of the single comparison.
+			Set2(T const& a, T const& b, bool swapped) :
+				_first(swapped ? b : a),
+				_second(swapped ? a : b) {}
+#endif
+
 			/// Storage of smaller element or element passed first
 			T _first;
 
@@ -137,9 +144,32 @@ namespace util {
 		return (a.first() == b.first()) && (a.second() == b.second());
 	}
 
+/// @brief Hash function for Set2 containers, for use with boost::hash:
+/// combines the hashes of the two elements in their canonical order.
+/// @relates Set2
+	template<typename T>
+	std::size_t hash_value(Set2<T> const& s) {
+		std::size_t seed = 0;
+		boost::hash_combine(seed, s.first());
+		boost::hash_combine(seed, s.second());
+		return seed;
+	}
+
 /// @}
 
 } // end of namespace util
 
+#ifndef BOOST_NO_CXX11_HDR_FUNCTIONAL
+namespace std {
+	/// @brief std::hash for Set2 containers (C++11), using hash_value().
+	template<typename T>
+	struct hash<util::Set2<T> > {
+		std::size_t operator()(util::Set2<T> const& s) const {
+			return util::hash_value(s);
+		}
+	};
+} // end of namespace std
+#endif
+
 #endif // INCLUDED_Set2_h_GUID_cfb4b70a_f756_4367_b64f_f76f4569deda
 
@@ -0,0 +1,461 @@
+/** @file
+	@brief Header providing a packed 64-bit encoding of Set2 pairs of 32-bit
+	integers, bulk canonicalization and sorting of such pairs, and a flat
+	hash map keyed on them.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_Set2Packed_h_GUID_fc053e50_b1bd_4790_bfb4_4b699ee6226c
+#define INCLUDED_Set2Packed_h_GUID_fc053e50_b1bd_4790_bfb4_4b699ee6226c
+
+// Internal Includes
+#include <util/Set2.h>
+
+// Library/third-party includes
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTIL_SET2PACKED_HAVE_SSE2
+#endif
+
+// Standard includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace util {
+	/// @addtogroup DataStructures
+	/// @{
+
+	/// @internal
+	namespace detail {
+		/// @brief Maps an integer of at most 32 bits to a std::uint32_t with
+		/// the same ordering, and back.
+		///
+		/// @internal
+		template<typename T, bool Signed = std::is_signed<T>::value>
+		struct Set2PackTraits {
+			static std::uint32_t toKey(T v) {
+				return std::uint32_t(v);
+			}
+			static T fromKey(std::uint32_t k) {
+				return T(k);
+			}
+		};
+
+		/// @brief Signed values are offset by 2^31 so they sort as unsigned.
+		///
+		/// @internal
+		template<typename T>
+		struct Set2PackTraits<T, true> {
+			static std::uint32_t toKey(T v) {
+				return std::uint32_t(std::int32_t(v)) ^ 0x80000000u;
+			}
+			static T fromKey(std::uint32_t k) {
+				return T(std::int32_t(k ^ 0x80000000u));
+			}
+		};
+
+		template<typename T>
+		struct Set2PackCheck {
+			static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+			              "Only Set2 pairs of integers up to 32 bits can be packed");
+			typedef Set2PackTraits<T> type;
+		};
+	} // end of namespace detail
+
+	/// @brief Packs a Set2 of integers up to 32 bits wide into 64 bits: the
+	/// smaller element in the high half, the larger in the low half.
+	///
+	/// Packed keys compare in the same order as the Set2 values they encode.
+	template<typename T>
+	inline std::uint64_t packSet2(Set2<T> const& s) {
+		typedef typename detail::Set2PackCheck<T>::type traits;
+		return (std::uint64_t(traits::toKey(s.first())) << 32) | traits::toKey(s.second());
+	}
+
+	/// @brief Packs the unordered pair (a, b), without constructing a Set2.
+	template<typename T>
+	inline std::uint64_t packSet2(T a, T b) {
+		typedef typename detail::Set2PackCheck<T>::type traits;
+		const std::uint32_t ka = traits::toKey(a);
+		const std::uint32_t kb = traits::toKey(b);
+		return kb < ka ? ((std::uint64_t(kb) << 32) | ka) : ((std::uint64_t(ka) << 32) | kb);
+	}
+
+	/// @brief Inverse of packSet2.
+	template<typename T>
+	inline Set2<T> unpackSet2(std::uint64_t key) {
+		typedef typename detail::Set2PackCheck<T>::type traits;
+		return Set2<T>(traits::fromKey(std::uint32_t(key >> 32)), traits::fromKey(std::uint32_t(key)));
+	}
+
+	/// @internal
+	namespace detail {
+		/// @brief Scalar packing of interleaved pairs [begin, n).
+		///
+		/// @internal
+		template<typename T>
+		inline void packSet2PairsScalar(const T * ab, std::size_t begin, std::size_t n, std::uint64_t * out) {
+			for (std::size_t i = begin; i < n; ++i) {
+				out[i] = packSet2(ab[2 * i], ab[2 * i + 1]);
+			}
+		}
+
+		/// @brief Packs interleaved pairs of 32-bit values, four at a time
+		/// where SSE2 is available.
+		///
+		/// @internal
+		template<typename T>
+		inline void packSet2Pairs32(const T * ab, std::size_t n, std::uint64_t * out) {
+			std::size_t i = 0;
+#ifdef UTIL_SET2PACKED_HAVE_SSE2
+			// SSE2 only has signed 32-bit compares: keys compare unsigned, so
+			// compare the values with the sign bit flipped for unsigned T (and
+			// as-is for signed T), and flip them all afterwards to get keys.
+			const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+			const __m128i toSigned = std::is_signed<T>::value ? _mm_setzero_si128() : bias;
+			for (; i + 4 <= n; i += 4) {
+				// a0 b0 a1 b1, a2 b2 a3 b3 -> a0 a1 b0 b1, a2 a3 b2 b3
+				__m128i p01 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ab + 2 * i)), _MM_SHUFFLE(3, 1, 2, 0));
+				__m128i p23 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ab + 2 * i + 4)), _MM_SHUFFLE(3, 1, 2, 0));
+				__m128i a = _mm_xor_si128(_mm_unpacklo_epi64(p01, p23), toSigned);
+				__m128i b = _mm_xor_si128(_mm_unpackhi_epi64(p01, p23), toSigned);
+				// Branchless min/max: SSE2 has no 32-bit min/max instructions.
+				__m128i bLess = _mm_cmplt_epi32(b, a);
+				__m128i lo = _mm_or_si128(_mm_and_si128(bLess, b), _mm_andnot_si128(bLess, a));
+				__m128i hi = _mm_or_si128(_mm_and_si128(bLess, a), _mm_andnot_si128(bLess, b));
+				lo = _mm_xor_si128(lo, bias);
+				hi = _mm_xor_si128(hi, bias);
+				// Each 64-bit key has the smaller value in its high half.
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_unpacklo_epi32(hi, lo));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 2), _mm_unpackhi_epi32(hi, lo));
+			}
+#endif
+			packSet2PairsScalar(ab, i, n, out);
+		}
+
+		template<typename T, bool Is32Bit = (sizeof(T) == 4)>
+		struct PackSet2Pairs {
+			static void apply(const T * ab, std::size_t n, std::uint64_t * out) {
+				packSet2PairsScalar(ab, 0, n, out);
+			}
+		};
+
+		template<typename T>
+		struct PackSet2Pairs<T, true> {
+			static void apply(const T * ab, std::size_t n, std::uint64_t * out) {
+				packSet2Pairs32(ab, n, out);
+			}
+		};
+	} // end of namespace detail
+
+	/// @brief Canonicalizes and packs n unordered pairs in one pass: ab holds
+	/// the pairs interleaved (a0, b0, a1, b1, ...), and out receives n keys
+	/// as from packSet2. Vectorized for 32-bit types where SSE2 is available.
+	template<typename T>
+	inline void packSet2Pairs(const T * ab, std::size_t n, std::uint64_t * out) {
+		detail::PackSet2Pairs<T>::apply(ab, n, out);
+	}
+
+	/// @brief Sorts packed keys (thus in Set2 order) and removes duplicates.
+	///
+	/// A least-significant-digit radix sort on 16-bit digits, skipping any
+	/// digit that is the same in every key - as the high bits of each half
+	/// are for small indices.
+	inline void sortUniqueSet2Keys(std::vector<std::uint64_t> & keys) {
+		const std::size_t n = keys.size();
+		if (n > 1) {
+			std::vector<std::uint64_t> scratch(n);
+			std::vector<std::size_t> counts(1 << 16);
+			for (unsigned shift = 0; shift < 64; shift += 16) {
+				std::fill(counts.begin(), counts.end(), 0);
+				for (std::size_t i = 0; i < n; ++i) {
+					++counts[(keys[i] >> shift) & 0xffff];
+				}
+				if (counts[(keys[0] >> shift) & 0xffff] == n) {
+					continue;
+				}
+				std::size_t total = 0;
+				for (std::size_t d = 0; d < counts.size(); ++d) {
+					const std::size_t c = counts[d];
+					counts[d] = total;
+					total += c;
+				}
+				for (std::size_t i = 0; i < n; ++i) {
+					scratch[counts[(keys[i] >> shift) & 0xffff]++] = keys[i];
+				}
+				keys.swap(scratch);
+			}
+		}
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	}
+
+	/// @brief Canonicalizes n interleaved unordered pairs (see
+	/// packSet2Pairs), then sorts and deduplicates them.
+	///
+	/// @returns the distinct pairs as packed keys, in Set2 order.
+	template<typename T>
+	inline std::vector<std::uint64_t> uniqueSet2Keys(const T * ab, std::size_t n) {
+		std::vector<std::uint64_t> keys(n);
+		if (n > 0) {
+			packSet2Pairs(ab, n, &keys[0]);
+		}
+		sortUniqueSet2Keys(keys);
+		return keys;
+	}
+
+	/// @brief Unpacks packed keys into Set2 values.
+	template<typename T>
+	inline void unpackSet2Keys(const std::uint64_t * keys, std::size_t n, Set2<T> * out) {
+		for (std::size_t i = 0; i < n; ++i) {
+			out[i] = unpackSet2<T>(keys[i]);
+		}
+	}
+
+	/// @brief An open-addressing hash map keyed on Set2 pairs of integers
+	/// up to 32 bits wide, for caches of symmetric pairs (collision pairs,
+	/// edges) looked up far more often than a tree can serve them.
+	///
+	/// Keys are stored packed (see packSet2) in one flat array probed
+	/// linearly, with values in a parallel array. An empty slot is marked by
+	/// a packed key that no Set2 can produce (smaller element greater than
+	/// the larger), so no separate occupancy flags are needed. Erasure
+	/// shifts later entries back rather than leaving tombstones.
+	///
+	/// V must be default-constructible. Like std::unordered_map, inserting
+	/// may invalidate pointers and references to values.
+	template<typename T, typename V>
+	class Set2Map {
+		public:
+			typedef Set2<T> key_type;
+			typedef V mapped_type;
+
+			Set2Map() : _size(0), _shift(64) {}
+
+			/// @brief Number of entries.
+			std::size_t size() const {
+				return _size;
+			}
+
+			/// @brief Whether there are no entries.
+			bool empty() const {
+				return _size == 0;
+			}
+
+			/// @brief Number of slots.
+			std::size_t capacity() const {
+				return _keys.size();
+			}
+
+			/// @brief Makes room for n entries without rehashing.
+			void reserve(std::size_t n) {
+				std::size_t cap = MinCapacity;
+				while (cap * MaxLoadNumerator < n * MaxLoadDenominator) {
+					cap *= 2;
+				}
+				if (cap > capacity()) {
+					rehash(cap);
+				}
+			}
+
+			/// @brief Pointer to the value for a pair, or null if absent.
+			V * find(Set2<T> const& k) {
+				return findPacked(packSet2(k));
+			}
+
+			/// @overload
+			V const* find(Set2<T> const& k) const {
+				return const_cast<Set2Map *>(this)->findPacked(packSet2(k));
+			}
+
+			/// @brief Pointer to the value for the unordered pair (a, b), or
+			/// null if absent.
+			V * find(T a, T b) {
+				return findPacked(packSet2(a, b));
+			}
+
+			/// @overload
+			V const* find(T a, T b) const {
+				return const_cast<Set2Map *>(this)->findPacked(packSet2(a, b));
+			}
+
+			/// @brief Whether there is an entry for a pair.
+			bool contains(Set2<T> const& k) const {
+				return find(k) != nullptr;
+			}
+
+			/// @brief The value for a pair, default-constructed first if absent.
+			V & operator[](Set2<T> const& k) {
+				return *insertPacked(packSet2(k), V()).first;
+			}
+
+			/// @brief Inserts a value for a pair if there is none already.
+			///
+			/// @returns a pointer to the value for the pair, and whether v was
+			/// inserted.
+			std::pair<V *, bool> insert(Set2<T> const& k, V const& v) {
+				return insertPacked(packSet2(k), v);
+			}
+
+			/// @brief Removes the entry for a pair, if any.
+			///
+			/// @returns whether an entry was removed.
+			bool erase(Set2<T> const& k) {
+				if (_keys.empty()) {
+					return false;
+				}
+				const std::uint64_t key = packSet2(k);
+				const std::size_t mask = _keys.size() - 1;
+				std::size_t i = home(key);
+				while (_keys[i] != key) {
+					if (_keys[i] == EmptyKey) {
+						return false;
+					}
+					i = (i + 1) & mask;
+				}
+				// Shift back later members of the probe run that would no
+				// longer be reachable past the hole.
+				std::size_t j = i;
+				while (true) {
+					j = (j + 1) & mask;
+					if (_keys[j] == EmptyKey) {
+						break;
+					}
+					const std::size_t h = home(_keys[j]);
+					const bool stays = (i <= j) ? (i < h && h <= j) : (i < h || h <= j);
+					if (!stays) {
+						_keys[i] = _keys[j];
+						_values[i] = std::move(_values[j]);
+						i = j;
+					}
+				}
+				_keys[i] = EmptyKey;
+				_values[i] = V();
+				--_size;
+				return true;
+			}
+
+			/// @brief Removes all entries, keeping the capacity.
+			void clear() {
+				for (std::size_t i = 0, e = _keys.size(); i < e; ++i) {
+					if (_keys[i] != EmptyKey) {
+						_keys[i] = EmptyKey;
+						_values[i] = V();
+					}
+				}
+				_size = 0;
+			}
+
+			/// @brief Calls f(Set2<T> const&, V &) for each entry, in no
+			/// particular order.
+			template<typename F>
+			void forEach(F f) {
+				for (std::size_t i = 0, e = _keys.size(); i < e; ++i) {
+					if (_keys[i] != EmptyKey) {
+						f(unpackSet2<T>(_keys[i]), _values[i]);
+					}
+				}
+			}
+
+		private:
+			/// @brief High half 1, low half 0: not a canonical Set2.
+			static const std::uint64_t EmptyKey = std::uint64_t(1) << 32;
+			static const std::size_t MinCapacity = 16;
+			static const std::size_t MaxLoadNumerator = 3;
+			static const std::size_t MaxLoadDenominator = 4;
+
+			/// @brief Fibonacci hashing: the high bits of the key times 2^64/phi.
+			std::size_t home(std::uint64_t key) const {
+				return std::size_t((key * UINT64_C(0x9E3779B97F4A7C15)) >> _shift);
+			}
+
+			V * findPacked(std::uint64_t key) {
+				if (_keys.empty()) {
+					return nullptr;
+				}
+				const std::size_t mask = _keys.size() - 1;
+				for (std::size_t i = home(key);; i = (i + 1) & mask) {
+					if (_keys[i] == key) {
+						return &_values[i];
+					}
+					if (_keys[i] == EmptyKey) {
+						return nullptr;
+					}
+				}
+			}
+
+			std::pair<V *, bool> insertPacked(std::uint64_t key, V const& v) {
+				if ((_size + 1) * MaxLoadDenominator > _keys.size() * MaxLoadNumerator) {
+					rehash(_keys.empty() ? std::size_t(MinCapacity) : _keys.size() * 2);
+				}
+				const std::size_t mask = _keys.size() - 1;
+				std::size_t i = home(key);
+				for (; _keys[i] != EmptyKey; i = (i + 1) & mask) {
+					if (_keys[i] == key) {
+						return std::make_pair(&_values[i], false);
+					}
+				}
+				_keys[i] = key;
+				_values[i] = v;
+				++_size;
+				return std::make_pair(&_values[i], true);
+			}
+
+			/// @brief Reinserts every entry into a table of cap slots (a power
+			/// of two).
+			void rehash(std::size_t cap) {
+				std::vector<std::uint64_t> oldKeys(cap, EmptyKey);
+				std::vector<V> oldValues(cap);
+				oldKeys.swap(_keys);
+				oldValues.swap(_values);
+				unsigned bits = 0;
+				while ((std::size_t(1) << bits) < cap) {
+					++bits;
+				}
+				_shift = 64 - bits;
+				const std::size_t mask = cap - 1;
+				for (std::size_t j = 0, e = oldKeys.size(); j < e; ++j) {
+					if (oldKeys[j] != EmptyKey) {
+						std::size_t i = home(oldKeys[j]);
+						while (_keys[i] != EmptyKey) {
+							i = (i + 1) & mask;
+						}
+						_keys[i] = oldKeys[j];
+						_values[i] = std::move(oldValues[j]);
+					}
+				}
+			}
+
+			std::vector<std::uint64_t> _keys;
+			std::vector<V> _values;
+			std::size_t _size;
+			unsigned _shift;
+	};
+
+	template<typename T, typename V>
+	const std::uint64_t Set2Map<T, V>::EmptyKey;
+
+	template<typename T, typename V>
+	const std::size_t Set2Map<T, V>::MinCapacity;
+
+	/// @}
+} // end of namespace util
+
+#endif // INCLUDED_Set2Packed_h_GUID_fc053e50_b1bd_4790_bfb4_4b699ee6226c
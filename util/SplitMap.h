@@ -30,45 +30,195 @@
 // - none
 
 // Standard includes
-// - none
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
 
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1800)
+#define UTIL_SPLITMAP_HAVE_CXX11
+#include <type_traits>
+#endif
 
 namespace util {
 
 /// @addtogroup FreeFunctions Free Functions
 /// @{
 
+	/// @internal
+	namespace detail {
+#ifdef UTIL_SPLITMAP_HAVE_CXX11
+		/// @brief Reserves space in a container that supports it.
+		///
+		/// @internal
+		template<class Container>
+		inline auto reserveForSplit(Container & c, std::size_t n, int) -> decltype(c.reserve(n), void()) {
+			c.reserve(n);
+		}
+
+		template<class Container>
+		inline void reserveForSplit(Container &, std::size_t, long) {}
+#else
+		/// @brief Reserves space in a container that supports it (only
+		/// std::vector is detected before C++11).
+		///
+		/// @internal
+		template<class Container>
+		inline void reserveForSplit(Container &, std::size_t, long) {}
+
+		template<class T, class Alloc>
+		inline void reserveForSplit(std::vector<T, Alloc> & c, std::size_t n, int) {
+			c.reserve(n);
+		}
+#endif
+	} // end of namespace detail
+
+/// Given a map, write all of its keys to an output iterator, returning the
+/// iterator past the last one written.
+	template<class MapType, class OutputIterator>
+	OutputIterator copyKeys(MapType const & map, OutputIterator out) {
+		for (typename MapType::const_iterator it = map.begin(), e = map.end(); it != e; ++it, ++out) {
+			*out = it->first;
+		}
+		return out;
+	}
+
+/// Given a map, write all of its values to an output iterator, returning
+/// the iterator past the last one written.
+	template<class MapType, class OutputIterator>
+	OutputIterator copyValues(MapType const & map, OutputIterator out) {
+		for (typename MapType::const_iterator it = map.begin(), e = map.end(); it != e; ++it, ++out) {
+			*out = it->second;
+		}
+		return out;
+	}
+
+/// Given a map, write its keys and values to two output iterators in a
+/// single pass, returning the iterators past the last ones written.
+	template<class MapType, class KeyIterator, class ValueIterator>
+	std::pair<KeyIterator, ValueIterator> splitInto(MapType const & map, KeyIterator keys, ValueIterator values) {
+		for (typename MapType::const_iterator it = map.begin(), e = map.end(); it != e; ++it, ++keys, ++values) {
+			*keys = it->first;
+			*values = it->second;
+		}
+		return std::make_pair(keys, values);
+	}
+
 /// Given a map, return a vector of all the keys
 	template<class MapType, class VectorType>
 	VectorType getAllKeys(MapType const & map) {
 		VectorType ret;
-		for (typename MapType::const_iterator it = map.begin(); it != map.end(); ++it) {
-			ret.push_back(it->first);
-		}
+		detail::reserveForSplit(ret, map.size(), 0);
+		copyKeys(map, std::back_inserter(ret));
 		return ret;
 	}
 
+/// @overload
+/// Returns a std::vector of the keys.
+	template<class MapType>
+	std::vector<typename MapType::key_type> getAllKeys(MapType const & map) {
+		return getAllKeys<MapType, std::vector<typename MapType::key_type> >(map);
+	}
+
 /// Given a map, return a vector of all the values
 	template<class MapType, class VectorType>
 	VectorType getAllValues(MapType const & map) {
 		VectorType ret;
-		for (typename MapType::const_iterator it = map.begin(); it != map.end(); ++it) {
-			ret.push_back(it->second);
-		}
+		detail::reserveForSplit(ret, map.size(), 0);
+		copyValues(map, std::back_inserter(ret));
 		return ret;
 	}
 
+/// @overload
+/// Returns a std::vector of the values.
+	template<class MapType>
+	std::vector<typename MapType::mapped_type> getAllValues(MapType const & map) {
+		return getAllValues<MapType, std::vector<typename MapType::mapped_type> >(map);
+	}
+
 /// Given a map, return a vector of keys and a vector of values
 	template<class MapType, class PairVectorType>
 	PairVectorType getSplit(MapType const & map) {
 		PairVectorType ret;
-		for (typename MapType::const_iterator it = map.begin(); it != map.end(); ++it) {
-			ret.first.push_back(it->first);
-			ret.second.push_back(it->second);
+		detail::reserveForSplit(ret.first, map.size(), 0);
+		detail::reserveForSplit(ret.second, map.size(), 0);
+		splitInto(map, std::back_inserter(ret.first), std::back_inserter(ret.second));
+		return ret;
+	}
+
+/// @overload
+/// Returns a pair of std::vectors.
+	template<class MapType>
+	std::pair<std::vector<typename MapType::key_type>, std::vector<typename MapType::mapped_type> >
+	getSplit(MapType const & map) {
+		return getSplit<MapType, std::pair<std::vector<typename MapType::key_type>, std::vector<typename MapType::mapped_type> > >(map);
+	}
+
+#ifdef UTIL_SPLITMAP_HAVE_CXX11
+/// @name Moving out of rvalue maps (C++11)
+/// Values are moved out of an rvalue map, and keys too where the map allows
+/// it (for example a vector of pairs, but not a std::map, whose keys are
+/// const).
+/// @{
+	template < class MapType, class OutputIterator,
+	           class = typename std::enable_if < !std::is_lvalue_reference<MapType>::value >::type >
+	OutputIterator copyKeys(MapType && map, OutputIterator out) {
+		for (auto it = map.begin(), e = map.end(); it != e; ++it, ++out) {
+			*out = std::move(it->first);
+		}
+		return out;
+	}
+
+	template < class MapType, class OutputIterator,
+	           class = typename std::enable_if < !std::is_lvalue_reference<MapType>::value >::type >
+	OutputIterator copyValues(MapType && map, OutputIterator out) {
+		for (auto it = map.begin(), e = map.end(); it != e; ++it, ++out) {
+			*out = std::move(it->second);
 		}
+		return out;
+	}
+
+	template < class MapType, class KeyIterator, class ValueIterator,
+	           class = typename std::enable_if < !std::is_lvalue_reference<MapType>::value >::type >
+	std::pair<KeyIterator, ValueIterator> splitInto(MapType && map, KeyIterator keys, ValueIterator values) {
+		for (auto it = map.begin(), e = map.end(); it != e; ++it, ++keys, ++values) {
+			*keys = std::move(it->first);
+			*values = std::move(it->second);
+		}
+		return std::make_pair(keys, values);
+	}
+
+	template < class MapType, class VectorType = std::vector<typename MapType::key_type>,
+	           class = typename std::enable_if < !std::is_lvalue_reference<MapType>::value >::type >
+	VectorType getAllKeys(MapType && map) {
+		VectorType ret;
+		detail::reserveForSplit(ret, map.size(), 0);
+		copyKeys(std::move(map), std::back_inserter(ret));
+		return ret;
+	}
+
+	template < class MapType, class VectorType = std::vector<typename MapType::mapped_type>,
+	           class = typename std::enable_if < !std::is_lvalue_reference<MapType>::value >::type >
+	VectorType getAllValues(MapType && map) {
+		VectorType ret;
+		detail::reserveForSplit(ret, map.size(), 0);
+		copyValues(std::move(map), std::back_inserter(ret));
 		return ret;
 	}
 
+	template < class MapType, class PairVectorType = std::pair < std::vector<typename MapType::key_type>,
+	           std::vector<typename MapType::mapped_type> > ,
+	           class = typename std::enable_if < !std::is_lvalue_reference<MapType>::value >::type >
+	PairVectorType getSplit(MapType && map) {
+		PairVectorType ret;
+		detail::reserveForSplit(ret.first, map.size(), 0);
+		detail::reserveForSplit(ret.second, map.size(), 0);
+		splitInto(std::move(map), std::back_inserter(ret.first), std::back_inserter(ret.second));
+		return ret;
+	}
+/// @}
+#endif // UTIL_SPLITMAP_HAVE_CXX11
+
 /// @}
 
 } // end of util namespace
@@ -0,0 +1,116 @@
+/** @file
+	@brief Header providing a multi-threaded split of random-access maps
+	into keys and values (requires C++11): see SplitMap.h for the serial
+	versions.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_SplitMapParallel_h_GUID_72df278a_59be_4fff_bbed_3d1321521230
+#define INCLUDED_SplitMapParallel_h_GUID_72df278a_59be_4fff_bbed_3d1321521230
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace util {
+
+/// @addtogroup FreeFunctions Free Functions
+/// @{
+
+	/// @internal
+	namespace detail {
+		/// @brief Serial cutoff for splitParallel: chunks smaller than
+		/// this are not worth a thread.
+		///
+		/// @internal
+		static const std::size_t SplitParallelMinChunk = 16384;
+	} // end of namespace detail
+
+/// Given a map with random-access iterators (such as a sorted vector of
+/// pairs, or a flat_map), write its keys and values to two random-access
+/// output iterators, splitting the work across threads: threadCount of 0
+/// means one per hardware thread. Small maps are split on the calling
+/// thread. Rethrows the first exception thrown by a copy, if any, once all
+/// threads are done.
+	template<class MapType, class KeyIterator, class ValueIterator>
+	void splitParallel(MapType const & map, KeyIterator keys, ValueIterator values, unsigned threadCount = 0) {
+		typedef typename MapType::const_iterator MapIterator;
+		static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<MapIterator>::iterator_category>::value,
+		              "splitParallel requires a map with random-access iterators");
+		static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<KeyIterator>::iterator_category>::value &&
+		              std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<ValueIterator>::iterator_category>::value,
+		              "splitParallel requires random-access output iterators");
+		const std::size_t n = map.size();
+		std::size_t chunks = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+		chunks = std::max<std::size_t>(1, std::min(chunks, n / detail::SplitParallelMinChunk));
+
+		const MapIterator first = map.begin();
+		std::vector<std::exception_ptr> errors(chunks);
+		auto runChunk = [&](std::size_t c) {
+			try {
+				const std::size_t b = n * c / chunks;
+				const std::size_t e = n * (c + 1) / chunks;
+				KeyIterator k = keys + b;
+				ValueIterator v = values + b;
+				for (MapIterator it = first + b, end = first + e; it != end; ++it, ++k, ++v) {
+					*k = it->first;
+					*v = it->second;
+				}
+			} catch (...) {
+				errors[c] = std::current_exception();
+			}
+		};
+		std::vector<std::thread> threads;
+		threads.reserve(chunks);
+		try {
+			for (std::size_t c = 1; c < chunks; ++c) {
+				threads.push_back(std::thread(runChunk, c));
+			}
+		} catch (...) {
+			for (std::size_t t = 0; t < threads.size(); ++t) {
+				threads[t].join();
+			}
+			throw;
+		}
+		runChunk(0);
+		for (std::size_t t = 0; t < threads.size(); ++t) {
+			threads[t].join();
+		}
+		for (std::size_t c = 0; c < chunks; ++c) {
+			if (errors[c]) {
+				std::rethrow_exception(errors[c]);
+			}
+		}
+	}
+
+/// @}
+
+} // end of util namespace
+
+#endif // INCLUDED_SplitMapParallel_h_GUID_72df278a_59be_4fff_bbed_3d1321521230
@@ -0,0 +1,56 @@
+/** @file
+	@brief Header providing lazy key and value views of std::maps (or
+	things that look like them), through Boost.Range (requires C++11): see
+	SplitMap.h for versions that copy into containers.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_SplitMapRange_h_GUID_293a5bd2_9af9_437f_aa6d_5d7649e412d6
+#define INCLUDED_SplitMapRange_h_GUID_293a5bd2_9af9_437f_aa6d_5d7649e412d6
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <boost/range/adaptor/map.hpp>
+
+// Standard includes
+// - none
+
+
+namespace util {
+
+/// @addtogroup FreeFunctions Free Functions
+/// @{
+
+/// Given a map, return a lazy range over its keys, without copying them.
+	template<class MapType>
+	auto keysOf(MapType & map) -> decltype(boost::adaptors::keys(map)) {
+		return boost::adaptors::keys(map);
+	}
+
+/// Given a map, return a lazy range over its values, without copying them.
+	template<class MapType>
+	auto valuesOf(MapType & map) -> decltype(boost::adaptors::values(map)) {
+		return boost::adaptors::values(map);
+	}
+
+/// @}
+
+} // end of util namespace
+
+#endif // INCLUDED_SplitMapRange_h_GUID_293a5bd2_9af9_437f_aa6d_5d7649e412d6
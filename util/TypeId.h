@@ -30,24 +30,31 @@
 #include <boost/operators.hpp>
 
 // Standard includes
+#include <cstddef>
+#include <functional>
 #include <typeinfo>
 
 namespace util {
 	/// @brief A simple wrapper/handle class for type_info for use in containers, etc.
+	///
+	/// The type_info hash code is computed once, at construction, so
+	/// hashing is free and comparisons only consult the type_info (which on
+	/// some ABIs compares mangled names) when the pointers differ but the
+	/// hashes agree.
 	class TypeId : public boost::totally_ordered<TypeId, boost::totally_ordered<TypeId, std::type_info> > {
 		private:
 			/// @brief Dummy empty type, used to indicate an empty typeid.
 			class NullType {};
 		public:
 			/// @brief default constructor - constructs an "empty" typeid.
-			TypeId() : _typeinfo(null_type_ptr()) {}
+			TypeId() : _typeinfo(null_type_ptr()), _hash(_typeinfo->hash_code()) {}
 
 			/// @brief constructor from type_info reference (return type of typeid operator)
-			TypeId(std::type_info const & ti) : _typeinfo(&ti) {}
+			TypeId(std::type_info const & ti) : _typeinfo(&ti), _hash(ti.hash_code()) {}
 
 			/// @brief Templated constructor using boost::mpl::identity as a wrapper.
 			template<typename T>
-			TypeId(boost::mpl::identity<T> const&) : _typeinfo(&typeid(T)) {}
+			TypeId(boost::mpl::identity<T> const&) : _typeinfo(&typeid(T)), _hash(typeid(T).hash_code()) {}
 
 			/// @brief templated static factory method - easier than nesting a typeid call.
 			template<typename T>
@@ -64,7 +71,9 @@ namespace util {
 				}
 			}
 
-			/** @brief Ordering method, based on std::type_info's before ordering method.
+			/** @brief Ordering method: by the cached hash code, falling back
+				to std::type_info's before ordering method only for distinct
+				types whose hash codes collide.
 
 				Used by the nonmember operator<()
 
@@ -74,13 +83,31 @@ namespace util {
 
 			*/
 			bool before(std::type_info const& other) const {
-				return get().before(other);
+				return before(TypeId(other));
 			}
 
 			bool before(TypeId const& other) const {
+				if (_typeinfo == other._typeinfo) {
+					return false;
+				}
+				if (_hash != other._hash) {
+					return _hash < other._hash;
+				}
 				return get().before(other.get());
 			}
 
+			/// @brief Equality, with fast paths for identical type_info
+			/// objects and for differing hash codes.
+			bool equals(TypeId const& other) const {
+				return _typeinfo == other._typeinfo ||
+				       (_hash == other._hash && get() == other.get());
+			}
+
+			/// @brief The type_info hash code, computed at construction.
+			std::size_t hash_code() const {
+				return _hash;
+			}
+
 			std::type_info const & get() const {
 				return *_typeinfo;
 			}
@@ -99,6 +126,7 @@ namespace util {
 		private:
 
 			std::type_info const * _typeinfo;
+			std::size_t _hash;
 
 	};
 
@@ -115,11 +143,85 @@ namespace util {
 	}
 
 	inline bool operator==(TypeId const& lhs, TypeId const& rhs) {
-		return lhs.get() == rhs.get();
+		return lhs.equals(rhs);
 	}
 
 	inline bool operator==(TypeId const& lhs, std::type_info const& rhs) {
-		return lhs.get() == rhs;
+		return lhs.getPointer() == &rhs || lhs.get() == rhs;
+	}
+
+	/// @brief Hash function for use with boost::hash
+	inline std::size_t hash_value(TypeId const& id) {
+		return id.hash_code();
+	}
+
+	namespace detail {
+		/// @brief A variable template stand-in: one object per type, whose
+		/// address identifies the type.
+		///
+		/// Deliberately not const: linkers that fold identical read-only
+		/// data (such as MSVC /OPT:ICF) could otherwise give two types the
+		/// same address.
+		///
+		/// @internal
+		template<typename T>
+		struct StaticTypeIdTag {
+			static char id;
+		};
+
+		template<typename T>
+		char StaticTypeIdTag<T>::id = 0;
+	} // end of namespace detail
+
+	/// @brief A type identifier that needs no RTTI: the address of an
+	/// object instantiated once per type, so it can be created in constant
+	/// expressions and compared and hashed as a pointer.
+	///
+	/// Unlike TypeId, it carries no name, and the identity of a type is
+	/// only guaranteed within one module (a DLL may have its own copy).
+	class StaticTypeId {
+		public:
+			/// @brief default constructor - constructs an "empty" id.
+			constexpr StaticTypeId() : _id(nullptr) {}
+
+			/// @brief templated static factory method.
+			template<typename T>
+			static constexpr StaticTypeId create() {
+				return StaticTypeId(&detail::StaticTypeIdTag<T>::id);
+			}
+
+			constexpr bool empty() const {
+				return _id == nullptr;
+			}
+
+			constexpr void const* getPointer() const {
+				return _id;
+			}
+
+			std::size_t hash_code() const {
+				return std::hash<void const*>()(_id);
+			}
+
+		private:
+			constexpr explicit StaticTypeId(void const* id) : _id(id) {}
+			void const* _id;
+	};
+
+	inline constexpr bool operator==(StaticTypeId const& lhs, StaticTypeId const& rhs) {
+		return lhs.getPointer() == rhs.getPointer();
+	}
+
+	inline constexpr bool operator!=(StaticTypeId const& lhs, StaticTypeId const& rhs) {
+		return !(lhs == rhs);
+	}
+
+	inline bool operator<(StaticTypeId const& lhs, StaticTypeId const& rhs) {
+		return std::less<void const*>()(lhs.getPointer(), rhs.getPointer());
+	}
+
+	/// @brief Hash function for use with boost::hash
+	inline std::size_t hash_value(StaticTypeId const& id) {
+		return id.hash_code();
 	}
 
 	template<typename StreamType>
@@ -129,4 +231,20 @@ namespace util {
 	}
 } // end of namespace util
 
+namespace std {
+	template<>
+	struct hash<util::TypeId> {
+		std::size_t operator()(util::TypeId const& id) const {
+			return id.hash_code();
+		}
+	};
+
+	template<>
+	struct hash<util::StaticTypeId> {
+		std::size_t operator()(util::StaticTypeId const& id) const {
+			return id.hash_code();
+		}
+	};
+} // end of namespace std
+
 #endif // INCLUDED_TypeId_h_GUID_db8ba085_2a20_480f_bea4_90d9ca6a4a3c
@@ -0,0 +1,341 @@
+/** @file
+	@brief Header providing a flat, type-keyed associative container.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_TypeMap_h_GUID_5d4400df_fe05_4095_ab77_d057c322ca07
+#define INCLUDED_TypeMap_h_GUID_5d4400df_fe05_4095_ab77_d057c322ca07
+
+// Internal Includes
+#include <util/TypeId.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace util {
+	/// @addtogroup DataStructures
+	/// @{
+
+	/// @internal
+	namespace detail {
+		/// @brief Hands out the next dense type index, shared by all TypeMaps.
+		///
+		/// @internal
+		inline std::size_t nextTypeMapIndex() {
+			static std::atomic<std::size_t> next(0);
+			return next++;
+		}
+	} // end of namespace detail
+
+	/// @brief The dense index of type T used by every TypeMap, assigned the
+	/// first time it is requested (thread-safe).
+	template<typename T>
+	inline std::size_t typeMapIndex() {
+		static const std::size_t index = detail::nextTypeMapIndex();
+		return index;
+	}
+
+	/// @brief A map from types to values of type V, for registries keyed on
+	/// TypeId that are looked up far more often than they change.
+	///
+	/// Types named at compile time are found through a contiguous vector at
+	/// their typeMapIndex, so a lookup is an array index rather than a tree
+	/// walk. Types seen only at runtime (through std::type_info or TypeId)
+	/// live in a hash map fallback until they are first accessed statically,
+	/// at which point they are moved into the vector. Either form of key
+	/// reaches the same entry.
+	///
+	/// Values are constructed in place in a pool of slots that never move
+	/// (a std::deque, which allocates them in blocks), and the vector and
+	/// hash map hold pointers into it. So, as with std::map, references and
+	/// pointers to a value stay valid until that entry is erased or the map
+	/// is cleared, whatever else is inserted, without a heap allocation per
+	/// value. The slots of erased entries are reused.
+	///
+	/// V must be default-constructible. The container itself is not
+	/// thread-safe.
+	template<typename V>
+	class TypeMap {
+		public:
+			typedef TypeId key_type;
+			typedef V mapped_type;
+
+			TypeMap() : _size(0) {}
+
+			/// @brief Takes over the entries of other, which is left empty.
+			/// References to the values stay valid.
+			TypeMap(TypeMap && other) : _size(0) {
+				swap(other);
+			}
+
+			/// @overload
+			TypeMap & operator=(TypeMap && other) {
+				if (this != &other) {
+					clear();
+					swap(other);
+				}
+				return *this;
+			}
+
+			TypeMap(TypeMap const&) = delete;
+			TypeMap & operator=(TypeMap const&) = delete;
+
+			~TypeMap() {
+				clear();
+			}
+
+			/// @brief Exchanges the entries of two maps. References to the
+			/// values stay valid.
+			void swap(TypeMap & other) {
+				_dense.swap(other._dense);
+				_denseIndices.swap(other._denseIndices);
+				_fallback.swap(other._fallback);
+				_slots.swap(other._slots);
+				_freeSlots.swap(other._freeSlots);
+				std::swap(_size, other._size);
+			}
+
+			/// @brief Number of entries.
+			std::size_t size() const {
+				return _size;
+			}
+
+			/// @brief Whether there are no entries.
+			bool empty() const {
+				return _size == 0;
+			}
+
+			/// @brief Pointer to the value for type T, or null if absent.
+			template<typename T>
+			V * find() {
+				const std::size_t i = typeMapIndex<T>();
+				if (i < _dense.size() && _dense[i]) {
+					return _dense[i];
+				}
+				if (_fallback.empty()) {
+					return nullptr;
+				}
+				return findFallback(TypeId::create<T>());
+			}
+
+			/// @overload
+			template<typename T>
+			V const* find() const {
+				return const_cast<TypeMap *>(this)->template find<T>();
+			}
+
+			/// @brief Pointer to the value for a runtime type, or null if absent.
+			V * find(TypeId const& id) {
+				typename DenseIndexMap::const_iterator it = _denseIndices.find(id);
+				if (it != _denseIndices.end()) {
+					return _dense[it->second];
+				}
+				return findFallback(id);
+			}
+
+			/// @overload
+			V const* find(TypeId const& id) const {
+				return const_cast<TypeMap *>(this)->find(id);
+			}
+
+			/// @brief Whether there is an entry for type T.
+			template<typename T>
+			bool contains() const {
+				return find<T>() != nullptr;
+			}
+
+			/// @brief Whether there is an entry for a runtime type.
+			bool contains(TypeId const& id) const {
+				return find(id) != nullptr;
+			}
+
+			/// @brief The value for type T, default-constructed first if absent.
+			template<typename T>
+			V & get() {
+				const std::size_t i = typeMapIndex<T>();
+				if (i < _dense.size() && _dense[i]) {
+					return *_dense[i];
+				}
+				return insertDense(i, TypeId::create<T>());
+			}
+
+			/// @brief The value for a runtime type, default-constructed first if
+			/// absent.
+			V & get(TypeId const& id) {
+				typename DenseIndexMap::const_iterator it = _denseIndices.find(id);
+				if (it != _denseIndices.end()) {
+					return *_dense[it->second];
+				}
+				typename FallbackMap::iterator existing = _fallback.find(id);
+				if (existing != _fallback.end()) {
+					return *existing->second;
+				}
+				// Only add the entry once its value exists, so a throwing
+				// constructor leaves the map unchanged.
+				V * value = createValue();
+				try {
+					_fallback.insert(std::make_pair(id, value));
+				} catch (...) {
+					destroyValue(value);
+					throw;
+				}
+				++_size;
+				return *value;
+			}
+
+			/// @brief Removes the entry for type T, if any.
+			///
+			/// @returns whether an entry was removed.
+			template<typename T>
+			bool erase() {
+				return erase(TypeId::create<T>());
+			}
+
+			/// @brief Removes the entry for a runtime type, if any.
+			///
+			/// @returns whether an entry was removed.
+			bool erase(TypeId const& id) {
+				typename DenseIndexMap::iterator it = _denseIndices.find(id);
+				if (it != _denseIndices.end()) {
+					V *& slot = _dense[it->second];
+					destroyValue(slot);
+					slot = nullptr;
+					_denseIndices.erase(it);
+					--_size;
+					return true;
+				}
+				typename FallbackMap::iterator fallback = _fallback.find(id);
+				if (fallback != _fallback.end()) {
+					destroyValue(fallback->second);
+					_fallback.erase(fallback);
+					--_size;
+					return true;
+				}
+				return false;
+			}
+
+			/// @brief Removes all entries.
+			void clear() {
+				for (typename DenseIndexMap::const_iterator it = _denseIndices.begin(), e = _denseIndices.end(); it != e; ++it) {
+					_dense[it->second]->~V();
+				}
+				for (typename FallbackMap::const_iterator it = _fallback.begin(), e = _fallback.end(); it != e; ++it) {
+					it->second->~V();
+				}
+				_dense.clear();
+				_denseIndices.clear();
+				_fallback.clear();
+				_slots.clear();
+				_freeSlots.clear();
+				_size = 0;
+			}
+
+			/// @brief Calls f(TypeId const&, V &) for each entry, in no
+			/// particular order.
+			template<typename F>
+			void forEach(F f) {
+				for (typename DenseIndexMap::const_iterator it = _denseIndices.begin(), e = _denseIndices.end(); it != e; ++it) {
+					f(it->first, *_dense[it->second]);
+				}
+				for (typename FallbackMap::iterator it = _fallback.begin(), e = _fallback.end(); it != e; ++it) {
+					f(it->first, *it->second);
+				}
+			}
+
+		private:
+			/// @brief Uninitialized storage for one value.
+			typedef typename std::aligned_storage<sizeof(V), std::alignment_of<V>::value>::type Slot;
+			typedef std::vector<V *> DenseVector;
+			typedef std::unordered_map<TypeId, std::size_t> DenseIndexMap;
+			typedef std::unordered_map<TypeId, V *> FallbackMap;
+
+			V * findFallback(TypeId const& id) {
+				typename FallbackMap::iterator it = _fallback.find(id);
+				return it == _fallback.end() ? nullptr : it->second;
+			}
+
+			/// @brief Default-constructs a value in a free slot, adding a slot
+			/// to the pool if there is none. If the constructor throws, the
+			/// slot stays free.
+			V * createValue() {
+				if (_freeSlots.empty()) {
+					_slots.emplace_back();
+					_freeSlots.push_back(&_slots.back());
+				}
+				V * value = new (_freeSlots.back()) V();
+				_freeSlots.pop_back();
+				return value;
+			}
+
+			/// @brief Destroys a value made by createValue() and frees its slot.
+			void destroyValue(V * value) {
+				_freeSlots.push_back(value);
+				value->~V();
+			}
+
+			/// @brief Slow path of get<T>(): makes room for index i, moving any
+			/// entry stored at runtime for the same type into place. Only the
+			/// pointer moves, so the value itself keeps its address.
+			V & insertDense(std::size_t i, TypeId const& id) {
+				if (i >= _dense.size()) {
+					_dense.resize(i + 1);
+				}
+				typename FallbackMap::iterator it = _fallback.find(id);
+				const bool created = it == _fallback.end();
+				V * value = created ? createValue() : it->second;
+				try {
+					_denseIndices[id] = i;
+				} catch (...) {
+					if (created) {
+						destroyValue(value);
+					}
+					throw;
+				}
+				_dense[i] = value;
+				if (created) {
+					++_size;
+				} else {
+					_fallback.erase(it);
+				}
+				return *value;
+			}
+
+			DenseVector _dense;
+			DenseIndexMap _denseIndices;
+			FallbackMap _fallback;
+			/// Storage for the values: a deque, so slots never move.
+			std::deque<Slot> _slots;
+			/// Addresses of the slots not holding a value.
+			std::vector<void *> _freeSlots;
+			std::size_t _size;
+	};
+
+	/// @}
+} // end of namespace util
+
+#endif // INCLUDED_TypeMap_h_GUID_5d4400df_fe05_4095_ab77_d057c322ca07
@@ -24,45 +24,34 @@
 
 // Internal Includes
 #include "ValueToTemplatePolicy.h"
+#include <util/IndexSequence.h>
 
 // Library/third-party includes
-#include <boost/mpl/vector.hpp>
-#include <boost/mpl/push_back.hpp>
 #include <boost/tuple/tuple.hpp>
 
 // Standard includes
-// - none
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
 
 namespace util {
 
 	namespace detail {
-		/// Class template used to perform recursive conversion of values in a tuple
-		/// to template parameters - delegates the actual conversion to SelectionPolicy
-		template<typename T, typename Op, template<class> class SelectionPolicy, typename Params = boost::mpl::vector<> >
-		struct ConvertHead {
-			typedef typename T::head_type head_type;
-			typedef typename T::tail_type tail_type;
-			typedef typename Op::result_type result_type;
-
-			template<typename Val>
-			struct Next : ConvertHead<tail_type, Op, SelectionPolicy, typename boost::mpl::push_back<Params, Val>::type > {};
-
-			static inline result_type apply(T const& input) {
-				return SelectionPolicy<head_type>::template apply<result_type, Next>(input.get_head(), input.get_tail());
-			}
-
-		};
-
-		/// Partial specialization for base case: have reached the end
-		/// of the tuple
-		template<typename Op, template<class> class SelectionPolicy, typename Params>
-		struct ConvertHead<boost::tuples::null_type, Op, SelectionPolicy, Params> {
-			typedef typename Op::result_type result_type;
-			static inline result_type apply(boost::tuples::null_type const&) {
-				return Op::template apply<Params>();
-			}
-		};
-
+		/// Dispatches on the elements of a boost::tuple
+		template<typename Op, template<class> class SelectionPolicy, typename Input, typename Fallback, std::size_t... Is>
+		inline typename Op::result_type convertBoostTuple(Input const& input, Fallback & fallback, index_sequence<Is...>) {
+			typedef ValueToTemplateTable < Op, MakeMplVector,
+			        SelectionPolicy<typename std::decay<typename boost::tuples::element<Is, Input>::type>::type>... > Table;
+			return dispatchOrFallback<Table>(input, fallback, boost::get<Is>(input)...);
+		}
+
+		/// Dispatches on the elements of a std::tuple
+		template<typename Op, template<class> class SelectionPolicy, typename Fallback, typename... Ts, std::size_t... Is>
+		inline typename Op::result_type convertStdTuple(std::tuple<Ts...> const& input, Fallback & fallback, index_sequence<Is...>) {
+			typedef ValueToTemplateTable < Op, MakeMplVector,
+			        SelectionPolicy<typename std::decay<Ts>::type>... > Table;
+			return dispatchOrFallback<Table>(input, fallback, std::get<Is>(input)...);
+		}
 	} // end of namespace detail
 
 	/// @addtogroup GenericProgramming Generic Programming
@@ -71,12 +60,46 @@ namespace util {
 	of the given metafunction with a mpl sequence template parameter equal
 	to the runtime values passed.
 
+	Every combination of template parameters is instantiated into a single
+	table of function pointers, so dispatch costs one table lookup and one
+	indirect call, however many parameters and values there are.
+
+	Each element type selects its template parameters with its
+	DefaultValueToTemplatePolicy: bool, int (in [0, 10]), RangedInt (in its
+	range), ValueSet (one of its values), or any type you specialize the
+	policy for. If a value has no template parameter, the policy throws.
+
 	@tparam Op Class defining a static function template called "apply"
 	and a typedef called "result_type"
 	*/
 	template<typename Op, typename Input>
 	inline typename Op::result_type ValueToTemplate(Input const& input) {
-		return detail::ConvertHead<Input, Op, DefaultValueToTemplatePolicy>::apply(input);
+		detail::NoValueToTemplateFallback fallback;
+		return detail::convertBoostTuple<Op, DefaultValueToTemplatePolicy>(input, fallback,
+		        make_index_sequence<boost::tuples::length<Input>::value>());
+	}
+
+	/// @overload
+	template<typename Op, typename... Ts>
+	inline typename Op::result_type ValueToTemplate(std::tuple<Ts...> const& input) {
+		detail::NoValueToTemplateFallback fallback;
+		return detail::convertStdTuple<Op, DefaultValueToTemplatePolicy>(input, fallback, index_sequence_for<Ts...>());
+	}
+
+	/** @brief Like ValueToTemplate, but instead of throwing when a value
+	has no template parameter, returns fallback(input): typically a generic
+	kernel taking its parameters at run time.
+	*/
+	template<typename Op, typename Input, typename Fallback>
+	inline typename Op::result_type ValueToTemplateWithFallback(Input const& input, Fallback fallback) {
+		return detail::convertBoostTuple<Op, DefaultValueToTemplatePolicy>(input, fallback,
+		        make_index_sequence<boost::tuples::length<Input>::value>());
+	}
+
+	/// @overload
+	template<typename Op, typename Fallback, typename... Ts>
+	inline typename Op::result_type ValueToTemplateWithFallback(std::tuple<Ts...> const& input, Fallback fallback) {
+		return detail::convertStdTuple<Op, DefaultValueToTemplatePolicy>(input, fallback, index_sequence_for<Ts...>());
 	}
 	/// @}
 
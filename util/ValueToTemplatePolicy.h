@@ -23,97 +23,282 @@
 #define INCLUDED_ValueToTemplatePolicy_h_GUID_a4d77a02_cd40_4742_b3fb_ebb4bdbd5503
 
 // Internal Includes
-// - none
+#include <util/IndexSequence.h>
+#include <util/RangedInt.h>
 
 // Library/third-party includes
 #include <boost/mpl/bool.hpp>
 #include <boost/mpl/int.hpp>
+#include <boost/mpl/vector.hpp>
 
 // Standard includes
+#include <cstddef>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 
 namespace util {
+	/** @brief Selection policies describe how the run-time values of one
+		type map onto template parameters, for ValueToTemplate and
+		FusionMapToTemplate.
+
+		A specialization of DefaultValueToTemplatePolicy for a value type
+		provides:
+
+		 - an enum value size: the number of possible template parameters
+		 - a member template at<I> with a typedef type: the template
+		   parameter for index I in [0, size)
+		 - a static function index(value) returning the index for a
+		   run-time value, or size if there is none
+		 - a static function outOfRange(value) that throws an exception
+		   describing a value with no index
+
+		so that dispatch can be done by looking up generated tables of
+		function pointers rather than by comparing against each value.
+
+		IntRangeSelectionPolicy and ValueSetSelectionPolicy may be used as
+		bases to specialize DefaultValueToTemplatePolicy for your own types
+		(for instance, enums).
+	*/
+	template<typename T>
+	struct DefaultValueToTemplatePolicy;
+
+	/// Selection policy for ints in [MinVal, MaxVal], mapped to boost::mpl::int_
+	template<int MinVal, int MaxVal>
+	struct IntRangeSelectionPolicy {
+		enum {
+			size = MaxVal - MinVal + 1
+		};
+
+		template<std::size_t I>
+		struct at {
+			typedef boost::mpl::int_ < MinVal + int(I) > type;
+		};
+
+		static inline std::size_t index(int val) {
+			return detail::isOutOfRange<MinVal, MaxVal>(val) ? std::size_t(size) : static_cast<std::size_t>(val - MinVal);
+		}
+
+		static inline void outOfRange(int val) {
+			std::ostringstream s;
+			s << "Out-of-range value passed for parameter - Given " << val << " when the range is [" << MinVal << ", " << MaxVal << "]";
+			throw std::runtime_error(s.str());
+		}
+	};
+
 	namespace detail {
+		template<typename T>
+		constexpr T packValueAt(std::size_t, T first) {
+			return first;
+		}
 
-		template<template<class> class Call, typename result_type, int Max, int Iter = 0>
-		struct call_type_from_int_impl {
-			template<typename FwdType>
-			static inline result_type apply(int val, FwdType const & d) {
-				if (val == Iter) {
-					return Call<boost::mpl::int_<Iter> >::apply(d);
-				}
-				return call_type_from_int_impl < Call, result_type, Max, Iter + 1 >::apply(val, d);
+		template<typename T, typename... Rest>
+		constexpr T packValueAt(std::size_t i, T first, Rest... rest) {
+			return i == 0 ? first : packValueAt<T>(i - 1, rest...);
+		}
+	} // end of namespace detail
+
+	/// Selection policy for an arbitrary set of values of an integral or
+	/// enum type T (e.g. sparse values like 1, 2, 4, 8, or the enumerators
+	/// of an enum), each mapped to std::integral_constant<T, Value>.
+	template<typename T, T... Values>
+	struct ValueSetSelectionPolicy {
+		enum {
+			size = sizeof...(Values)
+		};
+
+		template<std::size_t I>
+		struct at {
+			typedef std::integral_constant<T, detail::packValueAt<T>(I, Values...)> type;
+		};
+
+		/// Linear search: sets are expected to be small.
+		static inline std::size_t index(T val) {
+			const T values[] = {Values...};
+			std::size_t i = 0;
+			while (i < std::size_t(size) && !(values[i] == val)) {
+				++i;
 			}
+			return i;
+		}
+
+		static inline void outOfRange(T val) {
+			std::ostringstream s;
+			s << "Value passed for parameter is not one of the " << size << " allowed values - Given " << static_cast<long long>(val);
+			throw std::runtime_error(s.str());
+		}
+	};
+
+	/// A value wrapper type to pass to ValueToTemplate or
+	/// FusionMapToTemplate to select among a particular set of values,
+	/// instead of the default policy for T.
+	template<typename T, T... Values>
+	struct ValueSet {
+		T value;
+		ValueSet(T v) : value(v) {}
+		operator T() const {
+			return value;
+		}
+	};
+
+	namespace detail {
+		constexpr std::size_t productOfSizes() {
+			return 1;
+		}
+
+		template<typename... Sizes>
+		constexpr std::size_t productOfSizes(std::size_t first, Sizes... rest) {
+			return first * productOfSizes(rest...);
+		}
+
+		/// Product of the sizes following the first k: the stride of
+		/// dimension k in a flattened (last dimension fastest) index.
+		constexpr std::size_t strideAfter(std::size_t) {
+			return 1;
+		}
+
+		template<typename... Sizes>
+		constexpr std::size_t strideAfter(std::size_t k, std::size_t, Sizes... rest) {
+			return k == 0 ? productOfSizes(rest...) : strideAfter(k - 1, rest...);
+		}
+
+		/// Builder for ValueToTemplateTable passing a boost::mpl::vector of
+		/// the template parameters.
+		struct MakeMplVector {
+			template<typename... Vals>
+			struct apply {
+				typedef boost::mpl::vector<Vals...> type;
+			};
 		};
 
-		/// specialization for base case
-		template<template<class> class Call, typename result_type, int MaxVal>
-		struct call_type_from_int_impl<Call, result_type, MaxVal, MaxVal> {
-			template<typename FwdType>
-			static inline result_type apply(int val, FwdType const& d) {
-				if (val > MaxVal) {
-					std::ostringstream s;
-					s << "Out-of-range value passed for parameter - Given " << val << " when the max is " << MaxVal;
-					throw std::runtime_error(s.str());
+		/// Metafunction decoding a flat table index into the template
+		/// parameters it stands for (digit K of Flat, in mixed radix, selects
+		/// the parameter from policy K), passed to Builder::apply.
+		template<typename Builder, std::size_t Flat, typename Dims, typename... Policies>
+		struct FlatIndexToTemplateParams;
+
+		template<typename Builder, std::size_t Flat, std::size_t... Ks, typename... Policies>
+		struct FlatIndexToTemplateParams<Builder, Flat, index_sequence<Ks...>, Policies...> {
+			typedef typename Builder::template apply <
+			typename Policies::template at < (Flat / strideAfter(Ks, std::size_t(Policies::size)...)) % Policies::size >::type...
+			>::type type;
+		};
+
+		/// Array type whose brace-initialization is used to expand an
+		/// expression for each element of a pack, in order.
+		typedef int TableExpansion[];
+
+		/// A table of pointers to Op::apply instantiated for every
+		/// combination of template parameters the selection policies allow,
+		/// indexed by the flattened combination of each policy's index.
+		///
+		/// Everything is generated by pack expansion, so the instantiation
+		/// depth does not grow with the number of parameters or values.
+		template<typename Op, typename Builder, typename... Policies>
+		struct ValueToTemplateTable {
+			typedef typename Op::result_type result_type;
+			typedef result_type(*Function)();
+
+			static constexpr std::size_t size = productOfSizes(std::size_t(Policies::size)...);
+
+			template<std::size_t... Flat>
+			static inline Function const * functions(index_sequence<Flat...>) {
+				static const Function table[] = {
+					&Op::template apply<typename FlatIndexToTemplateParams<Builder, Flat, make_index_sequence<sizeof...(Policies)>, Policies...>::type>...
+				};
+				return table;
+			}
+
+			/// Computes the flat index with one index() call per policy, in
+			/// order: returns false if any value has no template parameter.
+			template<typename... Values>
+			static inline bool lookup(std::size_t & flat, Values const& ... values) {
+				const std::size_t indices[] = {Policies::index(values)..., 0};
+				const std::size_t sizes[] = {std::size_t(Policies::size)..., 1};
+				flat = 0;
+				bool found = true;
+				for (std::size_t i = 0; i < sizeof...(Policies); ++i) {
+					found = found && indices[i] < sizes[i];
+					flat = flat * sizes[i] + indices[i];
+				}
+				return found;
+			}
+
+			/// Returns the function to call for these values, or NULL if any
+			/// value has no template parameter.
+			template<typename... Values>
+			static inline Function find(Values const& ... values) {
+				std::size_t flat;
+				if (!lookup(flat, values...)) {
+					return NULL;
+				}
+				return functions(make_index_sequence<size>())[flat];
+			}
+
+			/// Calls the function for these values, or has the policy of the
+			/// first value without a template parameter throw. If that policy's
+			/// outOfRange() returns instead, throws std::runtime_error.
+			template<typename... Values>
+			static inline result_type apply(Values const& ... values) {
+				Function f = find(values...);
+				if (!f) {
+					(void)TableExpansion {0, (Policies::index(values) < std::size_t(Policies::size) ? 0 : (Policies::outOfRange(values), 0))...};
+					throw std::runtime_error("No template parameter for a value passed to ValueToTemplate, and its selection policy did not report it");
 				}
-				return Call<boost::mpl::int_<MaxVal> >::apply(d);
+				return f();
 			}
 		};
-		template<template<class> class Call, typename result_type, int MinVal, int MaxVal, typename FwdType>
-		inline result_type call_type_from_int_range(int val, FwdType const& fwdArgs) {
-			if (val < MinVal || val > MaxVal) {
-				std::ostringstream s;
-				s << "Out-of-range value passed for parameter - Given " << val << " when the range is [" << MinVal << ", " << MaxVal << "]";
-				throw std::runtime_error(s.str());
+
+		/// Fallback argument for front ends called without a fallback: values
+		/// without template parameters are reported by their policies.
+		struct NoValueToTemplateFallback {};
+
+		/// Calls the table entry for the values, or fallback(input) if there
+		/// isn't one.
+		template<typename Table, typename Input, typename Fallback, typename... Values>
+		inline typename Table::result_type dispatchOrFallback(Input const& input, Fallback & fallback, Values const& ... values) {
+			typename Table::Function f = Table::find(values...);
+			if (!f) {
+				return fallback(input);
 			}
-			return call_type_from_int_impl<Call, result_type, MaxVal, MinVal>::apply(val, fwdArgs);
+			return f();
 		}
 
-		template<template<class> class Call, typename result_type, typename FwdType>
-		inline result_type call_type_from_int(int val, FwdType const& fwdArgs) {
-			return call_type_from_int_range<Call, result_type, 0, 10>(val, fwdArgs);
+		template<typename Table, typename Input, typename... Values>
+		inline typename Table::result_type dispatchOrFallback(Input const&, NoValueToTemplateFallback &, Values const& ... values) {
+			return Table::apply(values...);
 		}
 	} // end of namespace detail
 
-	template<int MinVal, int MaxVal>
-	struct RangedInt {
-		int value;
-		RangedInt(int v) : value(v) {}
-		operator int() {
-			return value;
-		}
-	};
-	template<typename T>
-	struct DefaultValueToTemplatePolicy;
 	template<>
 	struct DefaultValueToTemplatePolicy<bool> {
+		enum {
+			size = 2
+		};
 
-		template<typename result_type, template<class> class Next, typename T, typename U>
-		static inline result_type apply(T const& value, U const& forwarding_args) {
-			if (value) {
-				return Next<typename boost::mpl::bool_<true> >::apply(forwarding_args);
-			}
-			return Next<typename boost::mpl::bool_<false> >::apply(forwarding_args);
+		template<std::size_t I>
+		struct at {
+			typedef boost::mpl::bool_ < I != 0 > type;
+		};
+
+		static inline std::size_t index(bool value) {
+			return value ? 1 : 0;
 		}
 
+		static inline void outOfRange(bool) {}
 	};
+
+	/// Plain ints are mapped onto the range [0, 10]
 	template<>
-	struct DefaultValueToTemplatePolicy<int> {
-		template<typename result_type, template<class> class Next, typename T, typename U>
-		static inline result_type apply(T const& value, U const& forwarding_args) {
-			return detail::call_type_from_int<Next, result_type>(value, forwarding_args);
-		}
-	};
+	struct DefaultValueToTemplatePolicy<int> : IntRangeSelectionPolicy<0, 10> {};
 
-	template<int MinVal, int MaxVal>
-	struct DefaultValueToTemplatePolicy<RangedInt<MinVal, MaxVal> > {
-		template<typename result_type, template<class> class Next, typename T, typename U>
-		static inline result_type apply(T const& value, U const& forwarding_args) {
-			return detail::call_type_from_int_range<Next, result_type, MinVal, MaxVal>(value.value, forwarding_args);
-		}
+	/// A RangedInt is mapped onto its range. Ranged ints that don't check
+	/// their range on construction can be used with a fallback.
+	template<int MinVal, int MaxVal, typename CheckingPolicy, typename ErrorPolicy>
+	struct DefaultValueToTemplatePolicy<RangedInt<MinVal, MaxVal, CheckingPolicy, ErrorPolicy> > : IntRangeSelectionPolicy<MinVal, MaxVal> {};
 
-	};
+	template<typename T, T... Values>
+	struct DefaultValueToTemplatePolicy<ValueSet<T, Values...> > : ValueSetSelectionPolicy<T, Values...> {};
 
 } // end of namespace util
 
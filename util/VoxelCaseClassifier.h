@@ -0,0 +1,318 @@
+/** @file
+	@brief Header providing bulk marching-cubes case classification of a
+	dense scalar field, using the vertex and edge conventions of
+	CubeComponents.
+
+	@versioninfo@
+
+	@date 2016
+
+	@author
+	Ryan Pavlik
+	<ryan.pavlik@gmail.com>
+	<http://ryanpavlik.com>
+*/
+
+//          Copyright Ryan Pavlik 2016.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef INCLUDED_VoxelCaseClassifier_h_GUID_196cef7f_294b_4334_93bb_91d7c29f0c1d
+#define INCLUDED_VoxelCaseClassifier_h_GUID_196cef7f_294b_4334_93bb_91d7c29f0c1d
+
+// Internal Includes
+#include <util/CubeComponents.h>
+
+// Library/third-party includes
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTIL_VOXELCASECLASSIFIER_SSE2
+#endif
+
+// Standard includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+	namespace detail {
+		/// @internal
+		/// @brief Sets out[i] to 0xFF if values[i] < iso, and 0 otherwise
+		/// (including for NaN).
+		inline void belowIsoMask(float const * values, std::size_t n, float iso, std::uint8_t * out) {
+			std::size_t i = 0;
+#if defined(__AVX2__)
+			const __m256 iso8 = _mm256_set1_ps(iso);
+			// packs works within 128-bit lanes, so the result needs its
+			// 32-bit groups put back in order.
+			const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+			for (; i + 32 <= n; i += 32) {
+				__m256i a = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(values + i), iso8, _CMP_LT_OQ));
+				__m256i b = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(values + i + 8), iso8, _CMP_LT_OQ));
+				__m256i c = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(values + i + 16), iso8, _CMP_LT_OQ));
+				__m256i d = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(values + i + 24), iso8, _CMP_LT_OQ));
+				__m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_permutevar8x32_epi32(packed, order));
+			}
+#endif
+#if defined(__AVX2__) || defined(UTIL_VOXELCASECLASSIFIER_SSE2)
+			const __m128 iso4 = _mm_set1_ps(iso);
+			for (; i + 16 <= n; i += 16) {
+				__m128i a = _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values + i), iso4));
+				__m128i b = _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values + i + 4), iso4));
+				__m128i c = _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values + i + 8), iso4));
+				__m128i d = _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values + i + 12), iso4));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+			}
+#endif
+			for (; i < n; ++i) {
+				out[i] = values[i] < iso ? 0xFF : 0x00;
+			}
+		}
+
+		/// @internal
+		/// @brief Combines the below-iso masks of the four point rows around
+		/// a row of cells into case indices: rYZ is the row offset by Y in y
+		/// and Z in z, and corner x + 2y + 4z becomes bit x + 2y + 4z.
+		inline void combineCaseRows(std::uint8_t const * r00, std::uint8_t const * r10,
+		                            std::uint8_t const * r01, std::uint8_t const * r11,
+		                            std::size_t cells, std::uint8_t * out) {
+			std::size_t x = 0;
+#if defined(__AVX2__)
+#define UTIL_VOXEL_CORNER_AVX2(ROW, OFFSET, BIT) \
+	_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(ROW + x + OFFSET)), \
+	                 _mm256_set1_epi8(static_cast<char>(1 << BIT)))
+			for (; x + 32 <= cells; x += 32) {
+				__m256i c = _mm256_or_si256(UTIL_VOXEL_CORNER_AVX2(r00, 0, 0), UTIL_VOXEL_CORNER_AVX2(r00, 1, 1));
+				c = _mm256_or_si256(c, _mm256_or_si256(UTIL_VOXEL_CORNER_AVX2(r10, 0, 2), UTIL_VOXEL_CORNER_AVX2(r10, 1, 3)));
+				c = _mm256_or_si256(c, _mm256_or_si256(UTIL_VOXEL_CORNER_AVX2(r01, 0, 4), UTIL_VOXEL_CORNER_AVX2(r01, 1, 5)));
+				c = _mm256_or_si256(c, _mm256_or_si256(UTIL_VOXEL_CORNER_AVX2(r11, 0, 6), UTIL_VOXEL_CORNER_AVX2(r11, 1, 7)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), c);
+			}
+#undef UTIL_VOXEL_CORNER_AVX2
+#endif
+#if defined(__AVX2__) || defined(UTIL_VOXELCASECLASSIFIER_SSE2)
+#define UTIL_VOXEL_CORNER_SSE2(ROW, OFFSET, BIT) \
+	_mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(ROW + x + OFFSET)), \
+	              _mm_set1_epi8(static_cast<char>(1 << BIT)))
+			for (; x + 16 <= cells; x += 16) {
+				__m128i c = _mm_or_si128(UTIL_VOXEL_CORNER_SSE2(r00, 0, 0), UTIL_VOXEL_CORNER_SSE2(r00, 1, 1));
+				c = _mm_or_si128(c, _mm_or_si128(UTIL_VOXEL_CORNER_SSE2(r10, 0, 2), UTIL_VOXEL_CORNER_SSE2(r10, 1, 3)));
+				c = _mm_or_si128(c, _mm_or_si128(UTIL_VOXEL_CORNER_SSE2(r01, 0, 4), UTIL_VOXEL_CORNER_SSE2(r01, 1, 5)));
+				c = _mm_or_si128(c, _mm_or_si128(UTIL_VOXEL_CORNER_SSE2(r11, 0, 6), UTIL_VOXEL_CORNER_SSE2(r11, 1, 7)));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), c);
+			}
+#undef UTIL_VOXEL_CORNER_SSE2
+#endif
+			for (; x < cells; ++x) {
+				out[x] = static_cast<std::uint8_t>((r00[x] & 0x01) | (r00[x + 1] & 0x02)
+				                                   | (r10[x] & 0x04) | (r10[x + 1] & 0x08)
+				                                   | (r01[x] & 0x10) | (r01[x + 1] & 0x20)
+				                                   | (r11[x] & 0x40) | (r11[x + 1] & 0x80));
+			}
+		}
+	} // end of namespace detail
+
+/// @addtogroup Math Math Utilities
+/// @{
+
+	/// @brief A surface crossing on one edge of one cell, found by
+	/// VoxelCaseClassifier::findEdgeIntersections()
+	struct VoxelEdgeIntersection {
+		/// Linear index of the cell
+		std::size_t cell;
+		/// Identifies the grid edge, independent of which of the (up to
+		/// four) cells sharing it reported it: the linear index of its lower
+		/// point times 3, plus its axis.
+		std::size_t edgeKey;
+		/// Cube edge ID in 0, 1, ..., 11 (see CubeComponents::edgeVertex())
+		std::uint8_t edge;
+		/// Interpolation parameter in [0, 1] from edge end 0 to end 1
+		float t;
+	};
+
+	/** @brief Computes marching-cubes case indices for every cell of a dense
+		scalar field, and the edge crossings they imply.
+
+		The field has nx * ny * nz points, with x varying fastest; cell
+		(x, y, z) has point (x, y, z) as its corner 0, and linear index
+		x + (nx - 1) * (y + (ny - 1) * z). Bit v of a case index is set if
+		cube vertex v (in the CubeComponents numbering, where vertex bit i is
+		the offset along axis i) has a value below the iso value.
+
+		Point signs are computed a plane at a time and combined into cases a
+		row at a time, with AVX2 or SSE2 when available and a branch-free
+		scalar fallback otherwise. Work is split into contiguous z-slabs, one
+		per thread.
+	*/
+	class VoxelCaseClassifier {
+		public:
+			/// @param nx,ny,nz Number of points in each dimension
+			/// @param threadCount Number of threads to split work over: 0 means
+			/// one per hardware thread.
+			VoxelCaseClassifier(std::size_t nx, std::size_t ny, std::size_t nz, unsigned threadCount = 0)
+				: _threadCount(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {
+				_points[0] = nx;
+				_points[1] = ny;
+				_points[2] = nz;
+				for (int i = 0; i < 3; ++i) {
+					_cells[i] = _points[i] > 1 ? _points[i] - 1 : 0;
+				}
+				for (std::uint8_t v = 0; v < 8; ++v) {
+					_cornerOffsets[v] = (v & 1) + ((v >> 1) & 1) * nx + ((v >> 2) & 1) * nx * ny;
+				}
+			}
+
+			/// @brief Total number of cells, and thus of case indices.
+			std::size_t cellCount() const {
+				return _cells[0] * _cells[1] * _cells[2];
+			}
+
+			std::size_t cellIndex(std::size_t x, std::size_t y, std::size_t z) const {
+				return x + _cells[0] * (y + _cells[1] * z);
+			}
+
+			std::size_t pointIndex(std::size_t x, std::size_t y, std::size_t z) const {
+				return x + _points[0] * (y + _points[1] * z);
+			}
+
+			/// @brief Write the case index of every cell to cases, which must
+			/// have room for cellCount() entries.
+			void classify(float const * field, float iso, std::uint8_t * cases) const {
+				if (cellCount() == 0) {
+					return;
+				}
+				const std::size_t planeSize = _points[0] * _points[1];
+				std::vector<std::uint8_t> planes(_slabCount() * 2 * planeSize);
+				_forEachSlab([&](std::size_t zBegin, std::size_t zEnd, std::size_t slab) {
+					std::uint8_t * lower = &(planes[slab * 2 * planeSize]);
+					std::uint8_t * upper = lower + planeSize;
+					detail::belowIsoMask(field + zBegin * planeSize, planeSize, iso, lower);
+					for (std::size_t z = zBegin; z < zEnd; ++z) {
+						detail::belowIsoMask(field + (z + 1) * planeSize, planeSize, iso, upper);
+						for (std::size_t y = 0; y < _cells[1]; ++y) {
+							std::uint8_t const * row = lower + y * _points[0];
+							std::uint8_t const * rowAbove = upper + y * _points[0];
+							detail::combineCaseRows(row, row + _points[0], rowAbove, rowAbove + _points[0],
+							                        _cells[0], cases + cellIndex(0, y, z));
+						}
+						std::swap(lower, upper);
+					}
+				});
+			}
+
+			/// @brief Append every surface crossing of every cell, given the
+			/// cases computed by classify(), to out, in cell order.
+			///
+			/// Edges shared between cells are reported once per cell: use
+			/// VoxelEdgeIntersection::edgeKey to merge them.
+			void findEdgeIntersections(float const * field, float iso, std::uint8_t const * cases,
+			                           std::vector<VoxelEdgeIntersection> & out) const {
+				if (cellCount() == 0) {
+					return;
+				}
+				std::vector<std::vector<VoxelEdgeIntersection> > perSlab(_slabCount());
+				_forEachSlab([&](std::size_t zBegin, std::size_t zEnd, std::size_t slab) {
+					for (std::size_t z = zBegin; z < zEnd; ++z) {
+						for (std::size_t y = 0; y < _cells[1]; ++y) {
+							std::size_t cell = cellIndex(0, y, z);
+							std::size_t point = pointIndex(0, y, z);
+							for (std::size_t x = 0; x < _cells[0]; ++x, ++cell, ++point) {
+								_addIntersections(field, iso, cases[cell], cell, point, perSlab[slab]);
+							}
+						}
+					}
+				});
+				std::size_t total = out.size();
+				for (std::size_t s = 0; s < perSlab.size(); ++s) {
+					total += perSlab[s].size();
+				}
+				out.reserve(total);
+				for (std::size_t s = 0; s < perSlab.size(); ++s) {
+					out.insert(out.end(), perSlab[s].begin(), perSlab[s].end());
+				}
+			}
+
+		private:
+			void _addIntersections(float const * field, float iso, std::uint8_t caseIndex, std::size_t cell,
+			                       std::size_t point, std::vector<VoxelEdgeIntersection> & found) const {
+				unsigned edges = CubeComponents::caseEdgeMask(caseIndex);
+				for (std::uint8_t e = 0; edges; ++e, edges >>= 1) {
+					if (edges & 1) {
+						std::size_t a = point + _cornerOffsets[CubeComponents::edgeVertex(e, 0)];
+						std::size_t b = point + _cornerOffsets[CubeComponents::edgeVertex(e, 1)];
+						VoxelEdgeIntersection hit;
+						hit.cell = cell;
+						hit.edgeKey = a * 3 + e / 4;
+						hit.edge = e;
+						hit.t = (iso - field[a]) / (field[b] - field[a]);
+						found.push_back(hit);
+					}
+				}
+			}
+
+			std::size_t _slabCount() const {
+				return std::min<std::size_t>(_threadCount, _cells[2]);
+			}
+
+			/// Calls f(zBegin, zEnd, slab) for each z-slab of cells, each in
+			/// its own thread (the first on the calling thread), rethrowing
+			/// the first exception thrown, if any, once all are done.
+			template<typename F>
+			void _forEachSlab(F const& f) const {
+				const std::size_t slabs = _slabCount();
+				std::vector<std::exception_ptr> errors(slabs);
+				auto runSlab = [&](std::size_t s) {
+					try {
+						f(_slabBegin(s, slabs), _slabBegin(s + 1, slabs), s);
+					} catch (...) {
+						errors[s] = std::current_exception();
+					}
+				};
+				std::vector<std::thread> threads;
+				threads.reserve(slabs);
+				try {
+					for (std::size_t s = 1; s < slabs; ++s) {
+						threads.push_back(std::thread(runSlab, s));
+					}
+				} catch (...) {
+					for (std::size_t t = 0; t < threads.size(); ++t) {
+						threads[t].join();
+					}
+					throw;
+				}
+				runSlab(0);
+				for (std::size_t t = 0; t < threads.size(); ++t) {
+					threads[t].join();
+				}
+				for (std::size_t s = 0; s < slabs; ++s) {
+					if (errors[s]) {
+						std::rethrow_exception(errors[s]);
+					}
+				}
+			}
+
+			std::size_t _slabBegin(std::size_t s, std::size_t slabs) const {
+				return _cells[2] * s / slabs;
+			}
+
+			std::size_t _points[3];
+			std::size_t _cells[3];
+			std::size_t _cornerOffsets[8];
+			unsigned _threadCount;
+	};
+
+/// @}
+
+} // end of namespace util
+
+#endif // INCLUDED_VoxelCaseClassifier_h_GUID_196cef7f_294b_4334_93bb_91d7c29f0c1d